@@ -16,19 +16,35 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
-    cell.cpp \
+    cell_map.cpp \
     grid.cpp \
     main.cpp \
     mainwindow.cpp \
     view.cpp
 
 HEADERS += \
+    arena_allocator.hpp \
+    async_planner.hpp \
+    astar.hpp \
+    batch_shortest_path.hpp \
+    bidirectional_search.hpp \
     breadth_first_search.hpp \
-    cell.hpp \
+    cancellation.hpp \
+    cell_map.hpp \
+    compressed_graph.hpp \
+    delta_stepping.hpp \
+    flow_field.hpp \
     graph.hpp \
     grid.hpp \
+    grid_graph.hpp \
+    jump_point_search.hpp \
+    lpastar.hpp \
     mainwindow.hpp \
+    parallel_breadth_first_search.hpp \
     shortest_path.hpp \
+    thread_pool.hpp \
+    vertex_map.hpp \
+    vertex_queue.hpp \
     view.hpp \
     visitor.hpp
 
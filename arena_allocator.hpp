@@ -0,0 +1,167 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// Hands out memory from large blocks. Freed chunks are kept on a free list per
+// size and reused, so containers with many equal nodes (list and hash nodes)
+// allocate a few blocks instead of one chunk per node. Everything is returned
+// at once by release() or the destructor. Not thread-safe.
+class Memory_arena
+{
+    struct Free_node
+    {
+        Free_node* next;
+        size_t size;
+    };
+
+public:
+    explicit Memory_arena(const size_t block_size = 1 << 16)
+        : m_BlockSize(block_size), m_Free(block_size / 4 / alignof(std::max_align_t) + 1, nullptr)
+    {
+
+    }
+
+    Memory_arena(const Memory_arena&) = delete;
+    Memory_arena& operator=(const Memory_arena&) = delete;
+
+    ~Memory_arena() { release(); }
+
+    void* allocate(size_t size, const size_t alignment)
+    {
+        if (alignment > alignof(std::max_align_t))
+            throw std::bad_alloc();
+        size = chunk_size(size);
+
+        // big chunks get a block of their own and are reused only at the same size
+        if (size > m_BlockSize / 4)
+        {
+            for (Free_node** link = &m_FreeBig; *link != nullptr; link = &(*link)->next)
+            {
+                if ((*link)->size == size)
+                {
+                    Free_node* node = *link;
+                    *link = node->next;
+                    return node;
+                }
+            }
+            return new_block(size);
+        }
+
+        Free_node*& head = m_Free[size / alignof(std::max_align_t)];
+        if (head != nullptr)
+        {
+            Free_node* node = head;
+            head = node->next;
+            return node;
+        }
+
+        if (size > m_Remaining)
+        {
+            m_Current = static_cast<char*>(new_block(m_BlockSize));
+            m_Remaining = m_BlockSize;
+        }
+        void* result = m_Current;
+        m_Current += size;
+        m_Remaining -= size;
+        return result;
+    }
+
+    void deallocate(void* pointer, const size_t size) noexcept
+    {
+        Free_node* node = static_cast<Free_node*>(pointer);
+        node->size = chunk_size(size);
+
+        Free_node*& head = node->size > m_BlockSize / 4 ? m_FreeBig : m_Free[node->size / alignof(std::max_align_t)];
+        node->next = head;
+        head = node;
+    }
+
+    void release()
+    {
+        for (auto block : m_Blocks)
+            ::operator delete(block);
+        m_Blocks.clear();
+        std::fill(m_Free.begin(), m_Free.end(), nullptr);
+        m_FreeBig = nullptr;
+        m_Current = nullptr;
+        m_Remaining = 0;
+    }
+
+    size_t blocks() const { return m_Blocks.size(); }
+
+private:
+    // chunks are multiples of the fundamental alignment, so every chunk cut from a block stays aligned
+    static size_t chunk_size(const size_t size) noexcept
+    {
+        const size_t granularity = alignof(std::max_align_t);
+        const size_t rounded = size < sizeof(Free_node) ? sizeof(Free_node) : size;
+        return (rounded + granularity - 1) / granularity * granularity;
+    }
+
+    void* new_block(const size_t size)
+    {
+        // the slot is reserved first so a block is never lost; a failed new leaves a null slot
+        m_Blocks.push_back(nullptr);
+        m_Blocks.back() = ::operator new(size);
+        return m_Blocks.back();
+    }
+
+    size_t m_BlockSize;
+    std::vector<void*> m_Blocks;
+    std::vector<Free_node*> m_Free;
+    Free_node* m_FreeBig = nullptr;
+    char* m_Current = nullptr;
+    size_t m_Remaining = 0;
+};
+
+// Standard allocator over a Memory_arena; copies and rebinds share the arena.
+template<class T>
+class Arena_allocator
+{
+public:
+    using value_type = T;
+
+    explicit Arena_allocator(Memory_arena& arena) noexcept
+        : m_Arena(&arena)
+    {
+
+    }
+
+    template<class U>
+    Arena_allocator(const Arena_allocator<U>& other) noexcept
+        : m_Arena(other.arena())
+    {
+
+    }
+
+    T* allocate(const size_t count)
+    {
+        return static_cast<T*>(m_Arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, const size_t count) noexcept
+    {
+        m_Arena->deallocate(pointer, count * sizeof(T));
+    }
+
+    Memory_arena* arena() const noexcept { return m_Arena; }
+
+private:
+    Memory_arena* m_Arena;
+};
+
+template<class T, class U>
+bool operator==(const Arena_allocator<T>& left, const Arena_allocator<U>& right) noexcept
+{
+    return left.arena() == right.arena();
+}
+
+template<class T, class U>
+bool operator!=(const Arena_allocator<T>& left, const Arena_allocator<U>& right) noexcept
+{
+    return !(left == right);
+}
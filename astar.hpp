@@ -0,0 +1,87 @@
+#pragma once
+#include "shortest_path.hpp"
+
+// Heuristics for grids whose vertex ids are row * width + column.
+template<class Label, class Weight>
+class Manhattan_heuristic
+{
+public:
+    Manhattan_heuristic() = default;
+
+    Manhattan_heuristic(const size_t width, const Label& target, const Weight& straight = 1)
+        : m_Width(width), m_Row(static_cast<size_t>(target) / width), m_Column(static_cast<size_t>(target) % width), m_Straight(straight)
+    {
+
+    }
+
+    Weight operator()(const Label& vertex) const
+    {
+        const size_t row = static_cast<size_t>(vertex) / m_Width;
+        const size_t column = static_cast<size_t>(vertex) % m_Width;
+        return static_cast<Weight>(difference(row, m_Row) + difference(column, m_Column)) * m_Straight;
+    }
+
+private:
+    static size_t difference(const size_t a, const size_t b) { return a > b ? a - b : b - a; }
+
+    size_t m_Width = 1;
+    size_t m_Row = 0;
+    size_t m_Column = 0;
+    Weight m_Straight = 1;
+};
+
+// For 8-connected grids with straight and diagonal step costs.
+template<class Label, class Weight>
+class Octile_heuristic
+{
+public:
+    Octile_heuristic() = default;
+
+    Octile_heuristic(const size_t width, const Label& target, const Weight& straight, const Weight& diagonal)
+        : m_Width(width), m_Row(static_cast<size_t>(target) / width), m_Column(static_cast<size_t>(target) % width),
+          m_Straight(straight), m_Diagonal(diagonal)
+    {
+
+    }
+
+    Weight operator()(const Label& vertex) const
+    {
+        const size_t row = static_cast<size_t>(vertex) / m_Width;
+        const size_t column = static_cast<size_t>(vertex) % m_Width;
+        const auto dr = static_cast<Weight>(row > m_Row ? row - m_Row : m_Row - row);
+        const auto dc = static_cast<Weight>(column > m_Column ? column - m_Column : m_Column - column);
+        const auto low = std::min(dr, dc);
+        const auto high = std::max(dr, dc);
+        return m_Straight * (high - low) + m_Diagonal * low;
+    }
+
+private:
+    size_t m_Width = 1;
+    size_t m_Row = 0;
+    size_t m_Column = 0;
+    Weight m_Straight = 1;
+    Weight m_Diagonal = 1;
+};
+
+template<class _Graph, class _Heuristic>
+auto AStar_shortest_path_unchecked(const _Graph& graph, const typename _Graph::label_type& source, const typename _Graph::label_type& target, const _Heuristic& heuristic)
+{
+    AStar_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Heuristic, _Graph> visitor(graph, source, heuristic);
+    visitor.add_target(target);
+    BFS_unchecked_static(graph, visitor);
+    return visitor.predecessor();
+}
+
+template<class _Graph, class _Heuristic>
+auto AStar_shortest_path(const _Graph& graph, const typename _Graph::label_type& source, const typename _Graph::label_type& target, const _Heuristic& heuristic)
+{
+    std::list<typename _Graph::label_type> path;
+    if (graph.exist(source) && graph.exist(target) && source != target)
+    {
+        AStar_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Heuristic, _Graph> visitor(graph, source, heuristic);
+        visitor.add_target(target);
+        BFS_unchecked_static(graph, visitor);
+        Construct_shortest_path(target, visitor, path);
+    }
+    return path;
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "lpastar.hpp"
+#include "cancellation.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+
+// Runs an LPAStar_planner on a thread of its own, over a private copy of the
+// graph that is kept in step by the opened and blocked vertices. Every call
+// cancels the search in progress and moves generation() on; the worker then
+// applies the accumulated changes and repairs the path from where the cancelled
+// search stopped. Each finished search is handed to the callback, on the worker
+// thread, together with the generation it reflects, so results that arrive after
+// newer calls can be recognised and dropped. The graph must be its own reverse
+// (undirected) and must keep the edge lists of removed vertices readable, as
+// Grid_graph does.
+template<class GraphType, class Heuristic>
+class Async_planner
+{
+public:
+    using label_type = typename GraphType::label_type;
+    using graph_type = GraphType;
+    using heuristic_type = Heuristic;
+    using planner_type = LPAStar_planner<graph_type, heuristic_type>;
+    using path_type = std::list<label_type>;
+    using callback_type = std::function<void(size_t generation, path_type path)>;
+
+    explicit Async_planner(callback_type callback)
+        : m_Planner(m_Graph, m_Graph), m_Callback(std::move(callback))
+    {
+        m_Worker = std::thread([this]() { run(); });
+    }
+
+    Async_planner(const Async_planner&) = delete;
+    Async_planner& operator=(const Async_planner&) = delete;
+
+    ~Async_planner()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+            m_Token.cancel();
+        }
+        m_Wake.notify_one();
+        m_Worker.join();
+    }
+
+    size_t generation() const { return m_Generation.load(); }
+
+    // replaces the worker's graph; earlier vertex changes are superseded
+    void assign(const graph_type& graph)
+    {
+        auto copy = std::make_unique<graph_type>(graph);
+        post([&]() {
+            m_PendingGraph = std::move(copy);
+            m_PendingVertices.clear();
+        });
+    }
+
+    template<class InputIterator>
+    void add_vertices(InputIterator First, InputIterator Last)
+    {
+        post([&]() {
+            for (; First != Last; ++First)
+                m_PendingVertices.emplace_back(*First, true);
+        });
+    }
+
+    template<class InputIterator>
+    void remove_vertices(InputIterator First, InputIterator Last)
+    {
+        post([&]() {
+            for (; First != Last; ++First)
+                m_PendingVertices.emplace_back(*First, false);
+        });
+    }
+
+    // the path from source to target is searched and kept up to date
+    void search(const label_type& source, const label_type& target, const heuristic_type& heuristic)
+    {
+        post([&]() {
+            m_Query = query_type{ true, source, target, heuristic };
+            m_QueryChanged = true;
+        });
+    }
+
+    // no path is searched until the next search()
+    void stop()
+    {
+        post([&]() {
+            m_Query.active = false;
+            m_QueryChanged = true;
+        });
+    }
+
+private:
+    struct query_type
+    {
+        bool active;
+        label_type source;
+        label_type target;
+        heuristic_type heuristic;
+    };
+
+    template<class Function>
+    void post(Function function)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            function();
+            ++m_Generation;
+            m_Token.cancel();
+        }
+        m_Wake.notify_one();
+    }
+
+    void run()
+    {
+        size_t done = 0;
+        while (true)
+        {
+            std::unique_ptr<graph_type> graph;
+            std::vector<std::pair<label_type, bool>> vertices;
+            query_type query{ false, label_type(), label_type(), heuristic_type() };
+            bool query_changed = false;
+            size_t generation = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Wake.wait(lock, [&]() { return m_Stop || m_Generation.load() != done; });
+                if (m_Stop)
+                    return;
+
+                graph = std::move(m_PendingGraph);
+                vertices.swap(m_PendingVertices);
+                query = m_Query;
+                query_changed = m_QueryChanged;
+                m_QueryChanged = false;
+                generation = m_Generation.load();
+                // calls made from here on cancel the search below
+                m_Token.reset();
+            }
+            done = generation;
+
+            // a new graph invalidates the whole search, which is started over below
+            if (graph)
+            {
+                m_Planner.clear();
+                m_Graph = std::move(*graph);
+                query_changed = true;
+            }
+            for (const auto& vertex : vertices)
+                update(vertex.first, vertex.second);
+
+            if (query_changed)
+            {
+                if (!query.active)
+                    m_Planner.clear();
+                else if (!m_Planner.active() || m_Planner.source() != query.source || m_Planner.target() != query.target)
+                    m_Planner.reset(query.source, query.target, query.heuristic);
+            }
+            if (!m_Planner.active())
+                continue;
+
+            if (m_Planner.compute_shortest_path(m_Token))
+                m_Callback(generation, m_Planner.shortest_path());
+        }
+    }
+
+    // the vertex and its neighbours have lost or gained an incoming edge
+    void update(const label_type& vertex, const bool opened)
+    {
+        if (opened)
+            m_Graph.add_vertex(vertex);
+        else
+            m_Graph.remove_vertex(vertex);
+
+        m_Planner.update_vertex(vertex);
+        std::for_each(m_Graph.map_cbegin(vertex), m_Graph.map_cend(vertex),
+            [&](const auto& neighbor) {
+                m_Planner.update_vertex(neighbor.target());
+            });
+    }
+
+    graph_type m_Graph;
+    planner_type m_Planner;
+    callback_type m_Callback;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    Cancellation_token m_Token;
+    std::atomic<size_t> m_Generation{0};
+    std::unique_ptr<graph_type> m_PendingGraph;
+    std::vector<std::pair<label_type, bool>> m_PendingVertices;
+    query_type m_Query{ false, label_type(), label_type(), heuristic_type() };
+    bool m_QueryChanged = false;
+    bool m_Stop = false;
+
+    std::thread m_Worker;
+};
@@ -0,0 +1,119 @@
+#pragma once
+#include "shortest_path.hpp"
+#include "thread_pool.hpp"
+#include <iterator>
+#include <numeric>
+
+// Paths of a batch stored back to back: path i is [cbegin(i), cend(i)),
+// empty when the target is unreachable or equal to the source.
+template<class Label>
+class Path_batch
+{
+public:
+    using label_type = Label;
+    using const_iterator = typename std::vector<label_type>::const_iterator;
+
+    Path_batch() = default;
+
+    Path_batch(std::vector<size_t>&& offsets, std::vector<label_type>&& vertices)
+        : m_Offsets(std::move(offsets)), m_Vertices(std::move(vertices))
+    {
+
+    }
+
+    size_t size() const { return m_Offsets.empty() ? 0 : m_Offsets.size() - 1; }
+    size_t path_size(const size_t path) const { return m_Offsets[path + 1] - m_Offsets[path]; }
+
+    const_iterator cbegin(const size_t path) const { return m_Vertices.cbegin() + m_Offsets[path]; }
+    const_iterator cend(const size_t path) const { return m_Vertices.cbegin() + m_Offsets[path + 1]; }
+
+private:
+    std::vector<size_t> m_Offsets;
+    std::vector<label_type> m_Vertices;
+};
+
+// Pairs sharing a source are answered by one search that stops once all of their
+// targets are settled. Each pool thread keeps its own reusable workspace.
+template<
+    class _Graph,
+    class _Visitor = Dijkstra_workspace<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Graph>,
+    class _RandomIterator
+>
+auto Batch_shortest_path(const _Graph& graph, _RandomIterator First, _RandomIterator Last, Thread_pool& pool)
+{
+    using label_type = typename _Graph::label_type;
+    using weight_type = distance_type<typename _Graph::weight_type>;
+
+    const size_t count = static_cast<size_t>(std::distance(First, Last));
+
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&](const size_t left, const size_t right) { return First[left].first < First[right].first; });
+
+    std::vector<size_t> groups;
+    for (size_t index = 0; index < count; ++index)
+    {
+        if (index == 0 || First[order[index]].first != First[order[index - 1]].first)
+            groups.push_back(index);
+    }
+    groups.push_back(count);
+
+    std::vector<_Visitor> workspaces;
+    std::vector<std::vector<label_type>> buffers(pool.size());
+    workspaces.reserve(pool.size());
+    for (size_t thread = 0; thread < pool.size(); ++thread)
+        workspaces.emplace_back(graph);
+
+    // per pair: thread buffer and offset inside it
+    std::vector<size_t> owner(count, 0);
+    std::vector<size_t> position(count, 0);
+    std::vector<size_t> offsets(count + 1, 0);
+
+    pool.parallel_for(groups.size() - 1,
+        [&](const size_t group, const size_t thread) {
+            const auto source = First[order[groups[group]]].first;
+            if (!graph.exist(source))
+                return;
+
+            auto& workspace = workspaces[thread];
+            auto& buffer = buffers[thread];
+
+            workspace.reset(graph, source);
+            for (size_t index = groups[group]; index < groups[group + 1]; ++index)
+            {
+                const auto target = First[order[index]].second;
+                if (graph.exist(target))
+                    workspace.add_target(target);
+            }
+            BFS_unchecked_static(graph, workspace);
+
+            for (size_t index = groups[group]; index < groups[group + 1]; ++index)
+            {
+                const size_t pair = order[index];
+                const auto target = First[pair].second;
+                if (target == source || !graph.exist(target) || workspace.distance(target) == std::numeric_limits<weight_type>::max())
+                    continue;
+
+                const size_t begin = buffer.size();
+                for (auto vertex = target; vertex != workspace.value_default(); vertex = workspace.predecessor(vertex))
+                    buffer.push_back(vertex);
+                std::reverse(buffer.begin() + begin, buffer.end());
+
+                owner[pair] = thread;
+                position[pair] = begin;
+                offsets[pair + 1] = buffer.size() - begin;
+            }
+        });
+
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<label_type> vertices(offsets.back());
+    pool.parallel_for(count,
+        [&](const size_t pair, const size_t) {
+            const auto First_vertex = buffers[owner[pair]].cbegin() + position[pair];
+            std::copy(First_vertex, First_vertex + (offsets[pair + 1] - offsets[pair]), vertices.begin() + offsets[pair]);
+        });
+
+    return Path_batch<label_type>(std::move(offsets), std::move(vertices));
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "shortest_path.hpp"
+#include "grid_graph.hpp"
+
+// Settles one vertex on one side and records the best path through any edge
+// that reaches a vertex already labelled by the opposite side.
+template<class _Graph, class _Visitor, class _Weight, class _Label>
+void Bidirectional_step(const _Graph& graph, _Visitor& visitor, const _Visitor& opposite, _Weight& best, _Label& from, _Label& to)
+{
+    auto processed_vertex = visitor._Visitor::extract_vertex();
+    const auto vertex = processed_vertex.target();
+
+    auto edges_list_begin = graph.map_cbegin(vertex);
+    auto edges_list_end = graph.map_cend(vertex);
+
+    if (!(visitor.distance(vertex) < processed_vertex.weight()))
+    {
+        std::for_each(edges_list_begin, edges_list_end,
+            [&](const auto& neighbor) {
+                const auto opposite_distance = opposite.distance(neighbor.target());
+                if (opposite_distance != std::numeric_limits<_Weight>::max())
+                {
+                    const auto total_distance = visitor.distance(vertex) + neighbor.weight() + opposite_distance;
+                    if (total_distance < best)
+                    {
+                        best = total_distance;
+                        from = vertex;
+                        to = neighbor.target();
+                    }
+                }
+            });
+    }
+
+    visitor._Visitor::handle(edges_list_begin, edges_list_end, processed_vertex);
+}
+
+// reverse_graph must hold the edges of graph reversed; the backward search runs on it from target.
+// For a Graph keep a transpose() next to it and pass that; building one per query
+// costs more than the search saves.
+template<class _Graph, class _Visitor = Dijkstra_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Graph>>
+auto Bidirectional_shortest_path(const _Graph& graph, const _Graph& reverse_graph, const typename _Graph::label_type& source, const typename _Graph::label_type& target)
+{
+    using label_type = typename _Graph::label_type;
+    using weight_type = distance_type<typename _Graph::weight_type>;
+
+    std::list<label_type> path;
+    if (graph.exist(source) && graph.exist(target) && source != target)
+    {
+        _Visitor forward(graph, source);
+        _Visitor backward(reverse_graph, target);
+
+        weight_type best = std::numeric_limits<weight_type>::max();
+        label_type forward_meeting = source;
+        label_type backward_meeting = target;
+        bool forward_turn = true;
+
+        while (!forward.empty() || !backward.empty())
+        {
+            // an exhausted side has final distances and bounds nothing
+            const weight_type forward_key = forward.empty() ? weight_type() : forward._Visitor::top_vertex().weight();
+            const weight_type backward_key = backward.empty() ? weight_type() : backward._Visitor::top_vertex().weight();
+            if (best != std::numeric_limits<weight_type>::max() && !(forward_key + backward_key < best))
+                break;
+
+            if (backward.empty() || (forward_turn && !forward.empty()))
+                Bidirectional_step(graph, forward, backward, best, forward_meeting, backward_meeting);
+            else
+                Bidirectional_step(reverse_graph, backward, forward, best, backward_meeting, forward_meeting);
+            forward_turn = !forward_turn;
+        }
+
+        if (best != std::numeric_limits<weight_type>::max())
+        {
+            Construct_shortest_path(forward_meeting, forward, path);
+            for (auto vertex = backward_meeting; vertex != backward.value_default(); vertex = backward.predecessor(vertex))
+                path.push_back(vertex);
+        }
+    }
+    return path;
+}
+
+template<class _Label, class _Weight>
+auto Bidirectional_shortest_path(const Grid_graph<_Label, _Weight>& graph, const _Label& source, const _Label& target)
+{
+    return Bidirectional_shortest_path(graph, graph, source, target);
+}
@@ -1,25 +1,169 @@
 #pragma once
 #include "visitor.hpp"
+#include "cancellation.hpp"
+#include <chrono>
 
-template<class _Label, class _Weight, class _Queue>
-void BFS_unchecked(const Graph<_Label, _Weight>& graph, Visitor_with_queue<_Label, _Weight, _Queue>* visitor)
+// One pass of the search loop: pops a queue entry, shows its vertex to function,
+// and relaxes the vertex's edges. The visitor calls are qualified, so they bypass
+// the vtable and the relaxation can be inlined. True once the visitor has
+// settled its last target.
+template<class _Graph, class _Visitor, class _Function>
+bool BFS_step(const _Graph& graph, _Visitor& visitor, _Function function)
 {
-    while (!visitor->empty())
+    auto processed_vertex = visitor._Visitor::extract_vertex();
+    function(processed_vertex.target());
+    if (visitor.settle(processed_vertex.target()))
+        return true;
+
+    auto edges_list_begin = graph.map_cbegin(processed_vertex.target());
+    auto edges_list_end = graph.map_cend(processed_vertex.target());
+
+    visitor._Visitor::handle(edges_list_begin, edges_list_end, processed_vertex);
+    return false;
+}
+
+// The search loop; stop() is checked before every pass. False if stop() fired
+// before the search finished.
+template<class _Graph, class _Visitor, class _Stop>
+bool BFS_unchecked_until(const _Graph& graph, _Visitor& visitor, _Stop stop)
+{
+    while (!visitor.empty())
+    {
+        if (stop())
+            return false;
+        if (BFS_step(graph, visitor, [](const auto&) {}))
+            break;
+    }
+    return true;
+}
+
+// Calls a visitor through its vtable, for callers that only hold the base class.
+template<class _Visitor>
+class Virtual_visitor
+{
+public:
+    explicit Virtual_visitor(_Visitor& visitor)
+        : m_Visitor(visitor)
+    {
+
+    }
+
+    bool empty() const { return m_Visitor.empty(); }
+    auto extract_vertex() { return m_Visitor.extract_vertex(); }
+
+    template<class _Label>
+    bool settle(const _Label& vertex) { return m_Visitor.settle(vertex); }
+
+    template<class _Iterator, class _Edge>
+    void handle(_Iterator& First, _Iterator& Last, const _Edge& processed_vertex) { m_Visitor.handle(First, Last, processed_vertex); }
+
+private:
+    _Visitor& m_Visitor;
+};
+
+template<class _Graph, class _Label, class _Weight, class _Queue, class _Storage>
+void BFS_unchecked(const _Graph& graph, Visitor_with_queue<_Label, _Weight, _Queue, _Graph, _Storage>* visitor)
+{
+    Virtual_visitor<Visitor_with_queue<_Label, _Weight, _Queue, _Graph, _Storage>> dispatch(*visitor);
+    BFS_unchecked_until(graph, dispatch, [] { return false; });
+}
+
+template<class _Graph, class _Visitor>
+void BFS_unchecked_static(const _Graph& graph, _Visitor& visitor)
+{
+    BFS_unchecked_until(graph, visitor, [] { return false; });
+}
+
+// Cancellable loops: false if the token was set before the search finished.
+template<class _Graph, class _Label, class _Weight, class _Queue, class _Storage>
+bool BFS_unchecked(const _Graph& graph, Visitor_with_queue<_Label, _Weight, _Queue, _Graph, _Storage>* visitor, const Cancellation_token& token)
+{
+    Virtual_visitor<Visitor_with_queue<_Label, _Weight, _Queue, _Graph, _Storage>> dispatch(*visitor);
+    return BFS_unchecked_until(graph, dispatch, [&token] { return token.cancelled(); });
+}
+
+template<class _Graph, class _Visitor>
+bool BFS_unchecked_static(const _Graph& graph, _Visitor& visitor, const Cancellation_token& token)
+{
+    return BFS_unchecked_until(graph, visitor, [&token] { return token.cancelled(); });
+}
+
+// The loop of BFS_unchecked_static cut into slices: every step() pops at most a
+// given number of queue entries and the next call resumes from the same queue,
+// so a frame or a timer tick can bound the work and draw the search as it grows.
+// The visitor ends up as BFS_unchecked_static would leave it once finished().
+template<class _Graph, class _Visitor>
+class Incremental_search
+{
+public:
+    Incremental_search(const _Graph& graph, _Visitor& visitor)
+        : m_Graph(graph), m_Visitor(visitor)
     {
-        auto processed_vertex = visitor->extract_vertex();
 
-        auto edges_list_begin = graph.map_cbegin(processed_vertex.target());
-        auto edges_list_end = graph.map_cend(processed_vertex.target());
+    }
 
-        visitor->handle(edges_list_begin, edges_list_end, processed_vertex);
+    // function(vertex) sees every popped vertex, stale queue entries included;
+    // true once the search is over
+    template<class Function>
+    bool step(size_t count, Function function)
+    {
+        for (; count != 0 && !finished(); --count)
+        {
+            ++m_Expanded;
+            m_Settled = BFS_step(m_Graph, m_Visitor, function);
+        }
+        return finished();
+    }
+
+    bool step(size_t count)
+    {
+        return step(count, [](const auto&) {});
     }
+
+    // steps until the budget is spent; the clock is read once per check entries
+    template<class Rep, class Period, class Function>
+    bool step_for(const std::chrono::duration<Rep, Period>& budget, Function function, const size_t check = 64)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + budget;
+        while (!step(check, function) && std::chrono::steady_clock::now() < deadline);
+        return finished();
+    }
+
+    template<class Rep, class Period>
+    bool step_for(const std::chrono::duration<Rep, Period>& budget)
+    {
+        return step_for(budget, [](const auto&) {});
+    }
+
+    bool finished() const { return m_Settled || m_Visitor.empty(); }
+    size_t expanded() const { return m_Expanded; }
+
+private:
+    const _Graph& m_Graph;
+    _Visitor& m_Visitor;
+    size_t m_Expanded = 0;
+    bool m_Settled = false;
+};
+
+template<class _Graph, class _Visitor>
+Incremental_search<_Graph, _Visitor> Make_incremental_search(const _Graph& graph, _Visitor& visitor)
+{
+    return Incremental_search<_Graph, _Visitor>(graph, visitor);
 }
 
-template<class _Label, class _Weight>
-auto Breadth_first_search(const Graph<_Label, _Weight>& graph, const _Label& source)
+template<class _Graph>
+auto Breadth_first_search(const _Graph& graph, const typename _Graph::label_type& source)
 {
-    BFS_visitor<_Label, _Weight> visitor(graph, source);
+    BFS_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Graph> visitor(graph, source);
     if (graph.exist(source))
-        BFS_unchecked(graph, &visitor);
+        BFS_unchecked_static(graph, visitor);
     return visitor;
 }
+
+template<class _Graph, class _Visitor>
+void Breadth_first_search(const _Graph& graph, const typename _Graph::label_type& source, _Visitor& workspace)
+{
+    workspace.reset(graph, source);
+    if (graph.exist(source))
+        BFS_unchecked_static(graph, workspace);
+}
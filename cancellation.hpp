@@ -0,0 +1,19 @@
+#pragma once
+#include <atomic>
+
+// Stop flag shared with a search running on another thread. The search polls
+// it once per expanded vertex and returns early when it is set.
+class Cancellation_token
+{
+public:
+    Cancellation_token() = default;
+    Cancellation_token(const Cancellation_token&) = delete;
+    Cancellation_token& operator=(const Cancellation_token&) = delete;
+
+    void cancel() { m_Cancelled.store(true, std::memory_order_relaxed); }
+    void reset() { m_Cancelled.store(false, std::memory_order_relaxed); }
+    bool cancelled() const { return m_Cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_Cancelled{false};
+};
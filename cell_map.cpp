@@ -0,0 +1,100 @@
+#include "cell_map.hpp"
+#include <algorithm>
+#include <cmath>
+
+CellMap::CellMap(const QSize& sizeGrid, const QSize& sizeCell)
+    : m_sizeGrid(sizeGrid), m_sizeCell(sizeCell), m_Image(sizeGrid.width(), sizeGrid.height(), QImage::Format_RGB32)
+{
+    m_Image.fill(color(Type::opened));
+    QGraphicsItem::setFlag(ItemUsesExtendedStyleOption);
+}
+
+CellMap::~CellMap()
+{
+
+}
+
+QRectF CellMap::boundingRect() const
+{
+    return QRectF(0, 0, m_sizeGrid.width() * m_sizeCell.width(), m_sizeGrid.height() * m_sizeCell.height());
+}
+
+void CellMap::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    const QRectF exposed = option->exposedRect.intersected(boundingRect());
+    if(exposed.isEmpty())
+        return;
+
+    const int w = m_sizeCell.width();
+    const int h = m_sizeCell.height();
+
+    // only the cells under the exposed rectangle are scaled from the image
+    const int left = std::max(0, static_cast<int>(exposed.left() / w));
+    const int top = std::max(0, static_cast<int>(exposed.top() / h));
+    const int right = std::min(m_sizeGrid.width(), static_cast<int>(std::ceil(exposed.right() / w)));
+    const int bottom = std::min(m_sizeGrid.height(), static_cast<int>(std::ceil(exposed.bottom() / h)));
+
+    const QRect cells(left, top, right - left, bottom - top);
+    const QRectF target(left * w, top * h, cells.width() * w, cells.height() * h);
+    painter->drawImage(target, m_Image, QRectF(cells));
+
+    // below a few pixels per cell the borders would only grey the picture
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if(lod * std::min(w, h) < 4)
+        return;
+
+    painter->setPen(Qt::black);
+    for(int column = left; column <= right; ++column)
+        painter->drawLine(QPointF(column * w, target.top()), QPointF(column * w, target.bottom()));
+    for(int row = top; row <= bottom; ++row)
+        painter->drawLine(QPointF(target.left(), row * h), QPointF(target.right(), row * h));
+
+    Q_UNUSED(widget);
+}
+
+void CellMap::setType(const size_t id, const Type type)
+{
+    const int column = id % m_sizeGrid.width();
+    const int row = id / m_sizeGrid.width();
+    m_Image.setPixel(column, row, color(type));
+    m_Dirty = m_Dirty.united(QRect(column, row, 1, 1));
+}
+
+void CellMap::flush()
+{
+    if(m_Dirty.isEmpty())
+        return;
+
+    const int w = m_sizeCell.width();
+    const int h = m_sizeCell.height();
+    QGraphicsItem::update(QRectF(m_Dirty.left() * w, m_Dirty.top() * h, m_Dirty.width() * w, m_Dirty.height() * h));
+    m_Dirty = QRect();
+}
+
+size_t CellMap::cellAt(const QPointF& position) const
+{
+    const int column = static_cast<int>(std::floor(position.x() / m_sizeCell.width()));
+    const int row = static_cast<int>(std::floor(position.y() / m_sizeCell.height()));
+
+    if(column < 0 || row < 0 || column >= m_sizeGrid.width() || row >= m_sizeGrid.height())
+        return size();
+    return static_cast<size_t>(row) * m_sizeGrid.width() + column;
+}
+
+QRectF CellMap::cellRect(const size_t id) const
+{
+    const int column = id % m_sizeGrid.width();
+    const int row = id / m_sizeGrid.width();
+    return QRectF(QPoint(column * m_sizeCell.width(), row * m_sizeCell.height()), m_sizeCell);
+}
+
+QRgb CellMap::color(const Type type)
+{
+    switch(type){
+    case Type::blocked:
+        return QColor(Qt::lightGray).rgb();
+    case Type::opened:
+    default:
+        return QColor(Qt::white).rgb();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <QObject>
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QImage>
+#include <QStyleOptionGraphicsItem>
+
+// The whole grid as a single scene item. Cell states are drawn into an image
+// with one pixel per cell, which is only for display (the grid graph holds the
+// cell types) and is scaled onto the exposed part of the scene, so the scene
+// index holds one item however large the grid is. Cell borders are only drawn
+// while a cell is large enough on screen to see them. Changes are collected and
+// invalidated together by flush().
+class CellMap: public QGraphicsItem
+{
+public:
+    enum class Type {opened, blocked};
+
+    CellMap(const QSize& sizeGrid, const QSize& sizeCell);
+    ~CellMap();
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    // the cell is repainted at the next flush
+    void setType(const size_t id, const Type type);
+    // one repaint for the bounding rectangle of the cells changed since the last flush
+    void flush();
+
+    // cell under a scene position, size() if there is none
+    size_t cellAt(const QPointF& position) const;
+    QRectF cellRect(const size_t id) const;
+    size_t size() const { return static_cast<size_t>(m_sizeGrid.width()) * m_sizeGrid.height(); }
+
+private:
+    static QRgb color(const Type type);
+
+    QSize m_sizeGrid;
+    QSize m_sizeCell;
+    QImage m_Image;
+    QRect m_Dirty;
+};
@@ -0,0 +1,164 @@
+#pragma once
+#include "graph.hpp"
+#include <vector>
+#include <unordered_map>
+#include <iterator>
+#include <stdexcept>
+#include <limits>
+
+// Immutable CSR snapshot of a Graph: labels are renumbered to dense indices
+// [0, size()) and searches run on the indices. Index and Weight may be narrower
+// than the source graph's types; construction throws if a vertex count or an
+// edge weight does not fit.
+template<
+    class Label, class Weight,
+    class Index = size_t,
+    class Hasher = std::hash<Label>,
+    class KeyEqual = std::equal_to<Label>
+>
+class Compressed_graph {
+public:
+    using label_type = Index;
+    using weight_type = Weight;
+    using original_label_type = Label;
+    using hasher = Hasher;
+    using key_equal = KeyEqual;
+
+    using edge_type = Edge<label_type, weight_type>;
+    using size_type = size_t;
+
+    class edge_const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = edge_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const edge_type*;
+        using reference = edge_type;
+
+        edge_const_iterator() = default;
+
+        edge_const_iterator(const label_type* target, const weight_type* weight)
+            : m_Target(target), m_Weight(weight)
+        {
+
+        }
+
+        edge_type operator*() const { return edge_type(*m_Target, *m_Weight); }
+
+        edge_const_iterator& operator++()
+        {
+            ++m_Target;
+            ++m_Weight;
+            return *this;
+        }
+        edge_const_iterator operator++(int)
+        {
+            edge_const_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const edge_const_iterator& other) const { return m_Target == other.m_Target; }
+        bool operator!=(const edge_const_iterator& other) const { return m_Target != other.m_Target; }
+
+    private:
+        const label_type* m_Target = nullptr;
+        const weight_type* m_Weight = nullptr;
+    };
+
+    using map_const_iterator = edge_const_iterator;
+
+    Compressed_graph() = default;
+
+    template<class GraphWeight, class GraphHasher, class GraphKeyEqual, class GraphAllocator>
+    explicit Compressed_graph(const Graph<Label, GraphWeight, GraphHasher, GraphKeyEqual, GraphAllocator>& graph)
+    {
+        init(graph);
+    }
+
+    size_type size() const { return m_Labels.size(); }
+    size_type edges_size() const { return m_Targets.size(); }
+    size_type map_size(const label_type& vertex) const { return m_Offsets[vertex + 1] - m_Offsets[vertex]; }
+
+    bool exist(const label_type& vertex) const { return static_cast<size_type>(vertex) < size(); }
+
+    label_type index(const original_label_type& label) const { return m_Index.at(label); }
+    original_label_type label(const label_type& vertex) const { return m_Labels.at(vertex); }
+
+    template<class Function>
+    void for_each_vertex(Function function) const
+    {
+        for (size_type vertex = 0; vertex < size(); ++vertex)
+            function(static_cast<label_type>(vertex));
+    }
+
+    map_const_iterator map_cbegin(const label_type& vertex) const
+    {
+        const auto offset = m_Offsets[vertex];
+        return map_const_iterator(m_Targets.data() + offset, m_Weights.data() + offset);
+    }
+    map_const_iterator map_cend(const label_type& vertex) const
+    {
+        const auto offset = m_Offsets[vertex + 1];
+        return map_const_iterator(m_Targets.data() + offset, m_Weights.data() + offset);
+    }
+
+private:
+    template<class GraphWeight>
+    static weight_type narrow(const GraphWeight& weight)
+    {
+        const auto result = static_cast<weight_type>(weight);
+        if (static_cast<GraphWeight>(result) != weight || (result < weight_type()) != (weight < GraphWeight()))
+            throw std::overflow_error("Compressed_graph: edge weight does not fit the weight type");
+        return result;
+    }
+
+    template<class GraphType>
+    void init(const GraphType& graph)
+    {
+        // the largest index stays free for the "no vertex" value
+        if (graph.size() > static_cast<size_t>(std::numeric_limits<label_type>::max()))
+            throw std::length_error("Compressed_graph: too many vertices for the index type");
+
+        m_Labels.reserve(graph.size());
+        m_Index.reserve(graph.size());
+        graph.for_each_vertex(
+            [&](const auto& label) {
+                m_Index.emplace(label, static_cast<label_type>(m_Labels.size()));
+                m_Labels.push_back(label);
+            });
+
+        m_Offsets.reserve(m_Labels.size() + 1);
+        m_Offsets.push_back(0);
+        for (const auto& label : m_Labels)
+        {
+            std::for_each(graph.map_cbegin(label), graph.map_cend(label),
+                [&](const auto& edge) {
+                    m_Targets.push_back(m_Index.at(edge.target()));
+                    m_Weights.push_back(narrow(edge.weight()));
+                });
+            m_Offsets.push_back(m_Targets.size());
+        }
+    }
+
+    std::vector<size_type> m_Offsets;
+    std::vector<label_type> m_Targets;
+    std::vector<weight_type> m_Weights;
+
+    std::vector<original_label_type> m_Labels;
+    std::unordered_map<original_label_type, label_type, hasher, key_equal> m_Index;
+};
+
+template<class Label, class Weight, class Index, class Hasher, class KeyEqual>
+struct is_graph<Compressed_graph<Label, Weight, Index, Hasher, KeyEqual>> : std::true_type {};
+
+template<class Label, class Weight, class Index, class Hasher, class KeyEqual>
+struct has_dense_labels<Compressed_graph<Label, Weight, Index, Hasher, KeyEqual>> : std::true_type {};
+
+template<class Label, class Weight, class Hasher, class KeyEqual, class Allocator>
+template<class Index, class StoredWeight>
+Compressed_graph<Label, StoredWeight, Index, Hasher, KeyEqual> Graph<Label, Weight, Hasher, KeyEqual, Allocator>::freeze() const
+{
+    return Compressed_graph<Label, StoredWeight, Index, Hasher, KeyEqual>(*this);
+}
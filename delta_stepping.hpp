@@ -0,0 +1,195 @@
+#pragma once
+#include "visitor.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+
+// Parallel single-source shortest paths by delta-stepping. Distances are grouped
+// into buckets of width delta; the light edges (weight <= delta) of the current
+// bucket are relaxed in parallel until it stops refilling, then its heavy edges
+// are relaxed once. Labels must be integral and dense, weights positive.
+// Returns the same predecessor and distance data as a Dijkstra_visitor; among
+// equally short predecessors the smallest label is kept.
+template<class _Graph>
+auto Delta_stepping(const _Graph& graph, const typename _Graph::label_type& source, const distance_type<typename _Graph::weight_type>& delta, Thread_pool& pool)
+{
+    using label_type = typename _Graph::label_type;
+    using weight_type = distance_type<typename _Graph::weight_type>;
+
+    static_assert(std::is_integral<label_type>::value, "Type Label is not integral.");
+    assert(delta > 0);
+
+    const size_t chunk = 256;
+    const auto infinity = std::numeric_limits<weight_type>::max();
+    const auto none = std::numeric_limits<label_type>::max();
+
+    size_t bound = 0;
+    graph.for_each_vertex(
+        [&](const auto& label) {
+            bound = std::max(bound, static_cast<size_t>(label) + 1);
+        }
+    );
+    const size_t chunks = (bound + chunk - 1) / chunk;
+
+    std::vector<std::atomic<weight_type>> distance(bound);
+    std::vector<std::atomic<label_type>> predecessor(bound);
+    pool.parallel_for(chunks,
+        [&](const size_t block, const size_t) {
+            for (size_t vertex = block * chunk; vertex < std::min(bound, (block + 1) * chunk); ++vertex)
+            {
+                distance[vertex].store(infinity, std::memory_order_relaxed);
+                predecessor[vertex].store(none, std::memory_order_relaxed);
+            }
+        });
+
+    // buckets[thread][index]: vertices queued by that thread, possibly stale
+    std::vector<std::vector<std::vector<label_type>>> buckets(pool.size());
+    const auto bucket_of = [&](const weight_type& weight) { return static_cast<size_t>(weight / delta); };
+
+    const auto relax = [&](const size_t thread, const label_type& vertex, const weight_type& candidate) {
+        auto current = distance[vertex].load(std::memory_order_relaxed);
+        while (candidate < current)
+        {
+            if (distance[vertex].compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+            {
+                auto& thread_buckets = buckets[thread];
+                const auto index = bucket_of(candidate);
+                if (index >= thread_buckets.size())
+                    thread_buckets.resize(index + 1);
+                thread_buckets[index].push_back(vertex);
+                break;
+            }
+        }
+    };
+
+    // relaxes the edges of frontier whose weight is light (or heavy) in parallel
+    const auto relax_edges = [&](const std::vector<label_type>& frontier, const bool light) {
+        pool.parallel_for((frontier.size() + chunk - 1) / chunk,
+            [&](const size_t block, const size_t thread) {
+                for (size_t index = block * chunk; index < std::min(frontier.size(), (block + 1) * chunk); ++index)
+                {
+                    const auto vertex = frontier[index];
+                    const auto vertex_distance = distance[vertex].load(std::memory_order_relaxed);
+                    std::for_each(graph.map_cbegin(vertex), graph.map_cend(vertex),
+                        [&](const auto& neighbor) {
+                            if ((neighbor.weight() <= delta) == light)
+                                relax(thread, neighbor.target(), vertex_distance + neighbor.weight());
+                        });
+                }
+            });
+    };
+
+    if (graph.exist(source))
+    {
+        distance[source].store(static_cast<weight_type>(0));
+        buckets[0].resize(1);
+        buckets[0][0].push_back(source);
+    }
+
+    // phase[vertex] - 1 is the last bucket the vertex was taken from
+    std::vector<size_t> phase(bound, 0);
+    std::vector<size_t> round(bound, 0);
+    std::vector<label_type> frontier;
+    std::vector<label_type> settled;
+    size_t rounds = 0;
+
+    for (size_t current = 0; ; ++current)
+    {
+        bool pending = false;
+        for (; !pending; ++current)
+        {
+            bool remaining = false;
+            for (const auto& thread_buckets : buckets)
+            {
+                remaining = remaining || thread_buckets.size() > current;
+                pending = pending || (thread_buckets.size() > current && !thread_buckets[current].empty());
+            }
+            if (pending || !remaining)
+                break;
+        }
+        if (!pending)
+            break;
+
+        settled.clear();
+        while (true)
+        {
+            ++rounds;
+            frontier.clear();
+            for (auto& thread_buckets : buckets)
+            {
+                if (thread_buckets.size() <= current)
+                    continue;
+                for (const auto& vertex : thread_buckets[current])
+                {
+                    if (bucket_of(distance[vertex].load(std::memory_order_relaxed)) != current || round[vertex] == rounds)
+                        continue;
+                    round[vertex] = rounds;
+                    frontier.push_back(vertex);
+                    if (phase[vertex] != current + 1)
+                    {
+                        phase[vertex] = current + 1;
+                        settled.push_back(vertex);
+                    }
+                }
+                thread_buckets[current].clear();
+            }
+            if (frontier.empty())
+                break;
+
+            relax_edges(frontier, true);
+        }
+        relax_edges(settled, false);
+    }
+
+    // any neighbour on a shortest path may serve as predecessor; keep the smallest
+    pool.parallel_for(chunks,
+        [&](const size_t block, const size_t) {
+            for (size_t index = block * chunk; index < std::min(bound, (block + 1) * chunk); ++index)
+            {
+                const auto vertex = static_cast<label_type>(index);
+                const auto vertex_distance = distance[index].load(std::memory_order_relaxed);
+                if (vertex_distance == infinity)
+                    continue;
+
+                std::for_each(graph.map_cbegin(vertex), graph.map_cend(vertex),
+                    [&](const auto& neighbor) {
+                        const auto target = neighbor.target();
+                        if (target == source || vertex_distance + neighbor.weight() != distance[target].load(std::memory_order_relaxed))
+                            return;
+                        auto current = predecessor[target].load(std::memory_order_relaxed);
+                        while (vertex < current && !predecessor[target].compare_exchange_weak(current, vertex, std::memory_order_relaxed));
+                    });
+            }
+        });
+
+    Index_map<label_type, label_type> predecessor_map(bound, none);
+    Index_map<label_type, weight_type> distance_map(bound, infinity);
+    pool.parallel_for(chunks,
+        [&](const size_t block, const size_t) {
+            for (size_t index = block * chunk; index < std::min(bound, (block + 1) * chunk); ++index)
+            {
+                predecessor_map[static_cast<label_type>(index)] = predecessor[index].load(std::memory_order_relaxed);
+                distance_map[static_cast<label_type>(index)] = distance[index].load(std::memory_order_relaxed);
+            }
+        });
+
+    return std::pair<Predecessor<label_type, Index_map<label_type, label_type>>, Distance<label_type, weight_type, Index_map<label_type, weight_type>>>(
+        std::piecewise_construct,
+        std::forward_as_tuple(std::move(predecessor_map)),
+        std::forward_as_tuple(std::move(distance_map)));
+}
+
+// delta defaults to the heaviest edge, so every edge is light
+template<class _Graph>
+auto Delta_stepping(const _Graph& graph, const typename _Graph::label_type& source, Thread_pool& pool)
+{
+    auto delta = static_cast<distance_type<typename _Graph::weight_type>>(1);
+    graph.for_each_vertex(
+        [&](const auto& label) {
+            std::for_each(graph.map_cbegin(label), graph.map_cend(label),
+                [&](const auto& neighbor) {
+                    delta = std::max(delta, static_cast<decltype(delta)>(neighbor.weight()));
+                });
+        }
+    );
+    return Delta_stepping(graph, source, delta, pool);
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "graph.hpp"
+#include "grid_graph.hpp"
+#include <vector>
+#include <cstdint>
+#include <list>
+#include <limits>
+#include <functional>
+#include <algorithm>
+
+// How the next step of every vertex is stored: its label in general.
+template<class GraphType>
+class Flow_step
+{
+public:
+    using label_type = typename GraphType::label_type;
+    using code_type = label_type;
+
+    Flow_step() = default;
+    explicit Flow_step(const GraphType&) {}
+
+    static code_type none() { return std::numeric_limits<code_type>::max(); }
+
+    code_type encode(const label_type&, const label_type& next) const { return next; }
+    label_type decode(const label_type&, const code_type& code) const { return code; }
+};
+
+// One byte per cell on a grid: the direction of the step, numbered as in
+// Grid_graph::neighbor.
+template<class Label, class Weight>
+class Flow_step<Grid_graph<Label, Weight>>
+{
+public:
+    using label_type = Label;
+    using code_type = std::uint8_t;
+
+    Flow_step() = default;
+    explicit Flow_step(const Grid_graph<Label, Weight>& graph)
+        : m_Width(graph.width())
+    {
+
+    }
+
+    static code_type none() { return 4; }
+
+    code_type encode(const label_type& vertex, const label_type& next) const
+    {
+        if (next + 1 == vertex)
+            return 0;
+        if (vertex + 1 == next)
+            return 1;
+        return static_cast<size_t>(next) + m_Width == static_cast<size_t>(vertex) ? 2 : 3;
+    }
+
+    label_type decode(const label_type& vertex, const code_type& code) const
+    {
+        switch (code)
+        {
+        case 0:
+            return vertex - 1;
+        case 1:
+            return vertex + 1;
+        case 2:
+            return static_cast<label_type>(vertex - m_Width);
+        default:
+            return static_cast<label_type>(vertex + m_Width);
+        }
+    }
+
+private:
+    size_t m_Width = 0;
+};
+
+// Distance to the nearest of a set of goals and the next vertex on the way there,
+// for every vertex at once, in two arrays indexed by label; distances are kept
+// in the promoted distance_type and steps as Flow_step codes. One multi-source
+// Dijkstra over the reverse graph (seeded with every goal at distance 0) fills
+// them; afterwards any number of agents walk to a goal by following next() with
+// no further search. Labels must be integral and dense, weights non-negative.
+// A Grid_graph is its own reverse, so its cell ids index the field directly.
+template<class GraphType>
+class Flow_field
+{
+public:
+    using graph_type = GraphType;
+    using label_type = typename graph_type::label_type;
+    using weight_type = distance_type<typename graph_type::weight_type>;
+    using step_type = Flow_step<graph_type>;
+    using code_type = typename step_type::code_type;
+
+    static_assert(std::is_integral<label_type>::value, "Type Label is not integral.");
+
+    Flow_field() = default;
+
+    // the arrays and the queue are reused, so recomputing a field of the same
+    // size allocates nothing once the queue has grown to its working size
+    template<class InputIterator>
+    void assign(const graph_type& reverse_graph, InputIterator First, InputIterator Last)
+    {
+        size_t bound = 0;
+        reverse_graph.for_each_vertex(
+            [&](const auto& label) {
+                bound = std::max(bound, static_cast<size_t>(label) + 1);
+            }
+        );
+        m_Distance.assign(bound, infinity());
+        m_Next.assign(bound, step_type::none());
+        m_Step = step_type(reverse_graph);
+        m_Queue.clear();
+
+        for (; First != Last; ++First)
+        {
+            const label_type source = *First;
+            if (reverse_graph.exist(source) && m_Distance[source] != static_cast<weight_type>(0))
+            {
+                m_Distance[source] = static_cast<weight_type>(0);
+                push(m_Distance[source], source);
+            }
+        }
+
+        while (!m_Queue.empty())
+        {
+            std::pop_heap(m_Queue.begin(), m_Queue.end(), std::greater<entry_type>());
+            const auto vertex_distance = m_Queue.back().first;
+            const auto vertex = m_Queue.back().second;
+            m_Queue.pop_back();
+
+            // stale entry of an already settled vertex
+            if (m_Distance[vertex] < vertex_distance)
+                continue;
+
+            std::for_each(reverse_graph.map_cbegin(vertex), reverse_graph.map_cend(vertex),
+                [&](const auto& neighbor) {
+                    const auto target = neighbor.target();
+                    const weight_type total_distance = vertex_distance + neighbor.weight();
+                    if (total_distance < m_Distance[target])
+                    {
+                        m_Distance[target] = total_distance;
+                        m_Next[target] = m_Step.encode(target, vertex);
+                        push(total_distance, target);
+                    }
+                });
+        }
+    }
+
+    weight_type distance(const label_type& vertex) const
+    {
+        return static_cast<size_t>(vertex) < m_Distance.size() ? m_Distance[vertex] : infinity();
+    }
+
+    // none() at a goal and for vertices that cannot reach one
+    label_type next(const label_type& vertex) const
+    {
+        if (static_cast<size_t>(vertex) >= m_Next.size() || m_Next[vertex] == step_type::none())
+            return none();
+        return m_Step.decode(vertex, m_Next[vertex]);
+    }
+
+    bool reachable(const label_type& vertex) const { return distance(vertex) != infinity(); }
+
+    // from vertex to the nearest goal, both included; empty if no goal is reachable
+    std::list<label_type> path(label_type vertex) const
+    {
+        std::list<label_type> result;
+        if (!reachable(vertex))
+            return result;
+
+        for (; vertex != none(); vertex = next(vertex))
+            result.push_back(vertex);
+        return result;
+    }
+
+    size_t size() const { return m_Distance.size(); }
+
+    static weight_type infinity() { return std::numeric_limits<weight_type>::max(); }
+    static label_type none() { return std::numeric_limits<label_type>::max(); }
+
+private:
+    using entry_type = std::pair<weight_type, label_type>;
+
+    void push(const weight_type& distance, const label_type& vertex)
+    {
+        m_Queue.emplace_back(distance, vertex);
+        std::push_heap(m_Queue.begin(), m_Queue.end(), std::greater<entry_type>());
+    }
+
+    std::vector<weight_type> m_Distance;
+    std::vector<code_type> m_Next;
+    step_type m_Step;
+    // min-heap storage kept between calls
+    std::vector<entry_type> m_Queue;
+};
+
+template<class _Graph, class _InputIterator>
+auto Multi_source_flow_field(const _Graph& reverse_graph, _InputIterator First, _InputIterator Last)
+{
+    Flow_field<_Graph> field;
+    field.assign(reverse_graph, First, Last);
+    return field;
+}
+
+template<class _Graph>
+auto Multi_source_flow_field(const _Graph& reverse_graph, const typename _Graph::label_type& source)
+{
+    return Multi_source_flow_field(reverse_graph, &source, &source + 1);
+}
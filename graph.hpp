@@ -6,10 +6,30 @@
 #include <vector>
 #include <exception>
 #include <iostream>
+#include <type_traits>
+#include <memory>
+#include <tuple>
 
 template<class T>
 using adjacency_matrix = std::vector<std::vector<T>>;
 
+template<class T>
+struct is_graph : std::false_type {};
+
+// True for graph types whose labels are the indices [0, size()) or a dense range
+// close to it, so per-vertex state can live in a flat vector. A generic Graph may
+// hold negative or sparse labels and keeps its state in std::map.
+template<class T>
+struct has_dense_labels : std::false_type {};
+
+// Type of a sum of weights along a path: narrow integer weights are promoted,
+// so searches over uint8_t edges keep distances in int.
+template<class Weight>
+using distance_type = decltype(std::declval<Weight>() + std::declval<Weight>());
+
+template<class Label, class Weight, class Index, class Hasher, class KeyEqual>
+class Compressed_graph;
+
 template<class Label, class Weight>
 class Edge {
 public:
@@ -46,25 +66,33 @@ namespace std {
     };
 }
 
+// Allocator is rebound for the edge lists, the incoming-edge index and the hash
+// tables, and every container of a graph shares one copy of it.
 template<
     class Label, class Weight,
     class Hasher = std::hash<Label>,
-    class KeyEqual = std::equal_to<Label>
+    class KeyEqual = std::equal_to<Label>,
+    class Allocator = std::allocator<Edge<Label, Weight>>
 >
 class Graph {
+    template<class T>
+    using rebind_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
     void init(const std::vector<Label>& vertices, adjacency_matrix<Weight>& matrix)
     {
 
         if (matrix.size() != vertices.size())
             throw std::bad_array_new_length();
 
+        for (size_t vertex = 0; vertex < vertices.size(); ++vertex)
+            add_vertex(vertices[vertex]);
+
         for (size_t vertex = 0; vertex < vertices.size(); ++vertex)
         {
             for (size_t neighbor = 0; neighbor < matrix[vertex].size(); ++neighbor)
             {
-                edge_type new_edge(vertices[neighbor], matrix[vertex][neighbor]);
-                if (new_edge.weight() != weight_type())
-                    m_Graph[vertices[vertex]].push_back(std::move(new_edge));
+                if (matrix[vertex][neighbor] != weight_type())
+                    add_edge(vertices[vertex], vertices[neighbor], matrix[vertex][neighbor]);
             }
         }
     }
@@ -73,10 +101,14 @@ public:
     using weight_type = Weight;
     using hasher = Hasher;
     using key_equal = KeyEqual;
+    using allocator_type = Allocator;
 
     using edge_type = Edge<label_type, weight_type>;
-    using map_type = std::list<edge_type>;
-    using container_type = std::unordered_map<label_type, map_type, hasher, key_equal>;
+    using map_type = std::list<edge_type, rebind_alloc<edge_type>>;
+    using container_type = std::unordered_map<label_type, map_type, hasher, key_equal, rebind_alloc<std::pair<const label_type, map_type>>>;
+    // sources of the incoming edges of every vertex, once per edge
+    using sources_type = std::vector<label_type, rebind_alloc<label_type>>;
+    using incoming_type = std::unordered_map<label_type, sources_type, hasher, key_equal, rebind_alloc<std::pair<const label_type, sources_type>>>;
 
     using size_type = typename container_type::size_type;
     using iterator = typename container_type::iterator;
@@ -86,45 +118,106 @@ public:
     using map_iterator = typename map_type::iterator;
     using map_const_iterator = typename map_type::const_iterator;
 
-    Graph() = default;
+    Graph()
+        : Graph(allocator_type())
+    {
+
+    }
+
+    explicit Graph(const allocator_type& allocator)
+        : m_Graph(0, hasher(), key_equal(), allocator), m_Incoming(0, hasher(), key_equal(), allocator), m_Allocator(allocator)
+    {
+
+    }
 
-    Graph(const std::vector<label_type>& vertices, adjacency_matrix<weight_type>& matrix)
+    Graph(const std::vector<label_type>& vertices, adjacency_matrix<weight_type>& matrix, const allocator_type& allocator = allocator_type())
+        : Graph(allocator)
     {
         init(vertices, matrix);
     }
 
     auto add_vertex(const label_type& label)
     {
-        return m_Graph.insert(std::make_pair(label, map_type()));
+        m_Incoming.emplace(std::piecewise_construct, std::forward_as_tuple(label), std::forward_as_tuple(m_Allocator));
+        return m_Graph.emplace(std::piecewise_construct, std::forward_as_tuple(label), std::forward_as_tuple(m_Allocator));
     }
     auto add_vertex(label_type&& label)
     {
-        return m_Graph.insert(std::make_pair(std::move(label), map_type()));
+        m_Incoming.emplace(std::piecewise_construct, std::forward_as_tuple(label), std::forward_as_tuple(m_Allocator));
+        return m_Graph.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(label)), std::forward_as_tuple(m_Allocator));
     }
+
+    // O(degree): only the edge lists of the vertex's neighbours are touched
     void remove_vertex(const label_type& vertex)
     {
         if (exist(vertex))
         {
+            for (const auto& source : m_Incoming.at(vertex))
+            {
+                if (!m_KeyEqual(source, vertex))
+                    exclude_edges(m_Graph.at(source), vertex);
+            }
+            for (const auto& edge : m_Graph.at(vertex))
+            {
+                if (!m_KeyEqual(edge.target(), vertex))
+                    exclude_sources(m_Incoming.at(edge.target()), vertex);
+            }
             m_Graph.erase(vertex);
-            for (auto& _vertex : m_Graph)
-                exclude_edges(_vertex.second, vertex);
+            m_Incoming.erase(vertex);
+        }
+    }
+
+    // edges between two removed vertices are dropped with them instead of being unlinked
+    template<class InputIterator>
+    void remove_vertices(InputIterator First, InputIterator Last)
+    {
+        std::unordered_set<label_type, hasher, key_equal> removed;
+        for (; First != Last; ++First)
+        {
+            if (exist(*First))
+                removed.insert(*First);
+        }
+
+        for (const auto& vertex : removed)
+        {
+            for (const auto& source : m_Incoming.at(vertex))
+            {
+                if (removed.find(source) == removed.end())
+                    exclude_edges(m_Graph.at(source), vertex);
+            }
+            for (const auto& edge : m_Graph.at(vertex))
+            {
+                if (removed.find(edge.target()) == removed.end())
+                    exclude_sources(m_Incoming.at(edge.target()), vertex);
+            }
+        }
+        for (const auto& vertex : removed)
+        {
+            m_Graph.erase(vertex);
+            m_Incoming.erase(vertex);
         }
     }
 
     void add_edge(const label_type& from, const label_type& to, const weight_type& weight)
     {
         if (exist(from) && exist(to))
-            m_Graph[from].push_back(edge_type(to, weight));
+        {
+            m_Graph.at(from).push_back(edge_type(to, weight));
+            m_Incoming.at(to).push_back(from);
+        }
     }
     void add_edge(const label_type& from, const label_type& to, const weight_type& weight1, const weight_type& weight2)
     {
         this->add_edge(from, to, weight1);
         this->add_edge(to, from, weight2);
     }
-    auto remove_edge(const label_type& from, const label_type& to)
+    void remove_edge(const label_type& from, const label_type& to)
     {
         if (exist(from) && exist(to))
-            exclude_edge(m_Graph[from], to);
+        {
+            exclude_edges(m_Graph.at(from), to);
+            exclude_sources(m_Incoming.at(to), from);
+        }
     }
 
     bool exist(const label_type& vertex) const
@@ -151,8 +244,8 @@ public:
         if (exist(from) && exist(to))
         {
 
-            auto First = m_Graph[from].begin();
-            const auto Last = m_Graph[from].end();
+            auto First = m_Graph.at(from).begin();
+            const auto Last = m_Graph.at(from).end();
 
             for (; First != Last; ++First)
             {
@@ -163,11 +256,45 @@ public:
         return result_list;
     }
 
+    template<class Function>
+    void for_each_vertex(Function function) const
+    {
+        for (const auto& vertex : m_Graph)
+            function(vertex.first);
+    }
+
+    template<class Index = size_t, class StoredWeight = weight_type>
+    Compressed_graph<label_type, StoredWeight, Index, hasher, key_equal> freeze() const;
+
+    Graph transpose() const
+    {
+        Graph result(m_Allocator);
+        for (const auto& vertex : m_Graph)
+            result.add_vertex(vertex.first);
+        for (const auto& vertex : m_Graph)
+        {
+            for (const auto& edge : vertex.second)
+                result.add_edge(edge.target(), vertex.first, edge.weight());
+        }
+        return result;
+    }
+
     size_type size() const { return m_Graph.size(); }
-    map_size_type map_size(const label_type& vertex) const { m_Graph.find(vertex)->second.size(); }
+    allocator_type get_allocator() const { return m_Allocator; }
+    map_size_type map_size(const label_type& vertex) const { return m_Graph.find(vertex)->second.size(); }
 
-    void clear() { m_Graph.clear(); }
-    void map_clear(const label_type& vertex) { m_Graph.find(vertex)->second.clear(); }
+    void clear()
+    {
+        m_Graph.clear();
+        m_Incoming.clear();
+    }
+    void map_clear(const label_type& vertex)
+    {
+        auto& map = m_Graph.find(vertex)->second;
+        for (const auto& edge : map)
+            exclude_sources(m_Incoming.at(edge.target()), vertex);
+        map.clear();
+    }
 
     iterator begin() { return m_Graph.begin(); }
     iterator end() { return m_Graph.end(); }
@@ -193,6 +320,16 @@ public:
         return m_Graph.at(vertex).cend();
     }
 
+    // sources of the edges into vertex, once per edge
+    typename sources_type::const_iterator incoming_cbegin(const label_type& vertex) const
+    {
+        return m_Incoming.at(vertex).cbegin();
+    }
+    typename sources_type::const_iterator incoming_cend(const label_type& vertex) const
+    {
+        return m_Incoming.at(vertex).cend();
+    }
+
 protected:
     void exclude_edges(map_type& map, const label_type& vertex)
     {
@@ -202,10 +339,21 @@ protected:
         map.erase(Iter, Last);
     }
 
+    void exclude_sources(sources_type& sources, const label_type& vertex)
+    {
+        sources.erase(std::remove_if(sources.begin(), sources.end(), [&](const auto& source) { return m_KeyEqual(source, vertex); }), sources.end());
+    }
+
 private:
     container_type m_Graph;
+    incoming_type m_Incoming;
+    key_equal m_KeyEqual;
+    allocator_type m_Allocator;
 };
 
+template<class Label, class Weight, class Hasher, class KeyEqual, class Allocator>
+struct is_graph<Graph<Label, Weight, Hasher, KeyEqual, Allocator>> : std::true_type {};
+
 template<class _Label, class _Weight>
 std::ostream& operator<<(std::ostream& out, Graph<_Label, _Weight>& graph)
 {
@@ -220,3 +368,5 @@ std::ostream& operator<<(std::ostream& out, Graph<_Label, _Weight>& graph)
     }
     return out;
 }
+
+#include "compressed_graph.hpp"
@@ -1,40 +1,85 @@
 #include "grid.hpp"
 
 Grid::Grid(QObject* parent)
-    : QGraphicsScene(parent)
+    : QGraphicsScene(parent), m_Planner([this](const size_t generation, path_type path) {
+          // delivered on the planner's thread, applied on the GUI thread
+          QMetaObject::invokeMethod(this, [this, generation, path]() { updatePath(generation, path); }, Qt::QueuedConnection);
+      })
 {
 
 }
 
-void Grid::generationRandomWalls(const size_t count)
+// Floyd's algorithm: exactly count distinct positions out of size with one draw
+// each, marked in a bitset. Dense subsets are sampled through their complement.
+static std::vector<bool> randomSubset(const size_t size, const size_t count, QRandomGenerator& generator)
 {
-    std::uniform_int_distribution<> distrib(0, Grid::width() * Grid::height() - 1);
-    std::set<size_t> walls;
+    const bool invert = count > size / 2;
+    const size_t samples = invert ? size - count : count;
 
-    while(walls.size() != count)
+    std::vector<bool> subset(size, false);
+    for(size_t last = size - samples; last < size; ++last)
     {
-        const size_t value = distrib(*QRandomGenerator::global());
+        std::uniform_int_distribution<size_t> distrib(0, last);
+        const size_t value = distrib(generator);
+        subset[subset[value] ? last : value] = true;
+    }
 
-        if(m_selectedPoint.first != nullptr)
-        {
-            if(m_selectedPoint.first->id() == value)
-                continue;
-        }
-        if(m_selectedPoint.second != nullptr)
-        {
-            if(m_selectedPoint.second->id() == value)
-                continue;
-        }
+    if(invert)
+        subset.flip();
+    return subset;
+}
+
+std::vector<bool> Grid::randomWalls(const size_t count) const
+{
+    const size_t cells = static_cast<size_t>(Grid::width()) * Grid::height();
+    const size_t first = m_numbSelectedCell > 0 ? m_selectedPoint.first : cells;
+    const size_t second = m_numbSelectedCell > 1 ? m_selectedPoint.second : cells;
+    const size_t available = cells - (first != cells) - (second != cells);
+
+    QRandomGenerator generator(QRandomGenerator::global()->generate());
+    const std::vector<bool> subset = randomSubset(available, std::min(count, available), generator);
+
+    // selected points are skipped, the other cells take the positions in order
+    std::vector<bool> walls(cells, false);
+    for(size_t id = 0, position = 0; id < cells; ++id)
+    {
+        if(id == first || id == second)
+            continue;
+        walls[id] = subset[position++];
+    }
+    return walls;
+}
+
+void Grid::setWalls(const std::vector<bool>& walls)
+{
+    std::vector<size_t> opened;
+    std::vector<size_t> blocked;
 
-        if(walls.find(value) == walls.end())
-            walls.insert(value);
+    // only the cells whose state differs are touched
+    for(size_t id = 0; id < walls.size(); ++id)
+    {
+        if(walls[id] && m_Graph.exist(id))
+            blocked.push_back(id);
+        else if(!walls[id] && !m_Graph.exist(id))
+            opened.push_back(id);
     }
 
-   for(auto& id: walls)
-   {
-      m_Graph.remove_vertex(id);
-      static_cast<Cell*>(m_Cells[id])->setType(Cell::Type::blocked);
-   }
+    m_Graph.remove_vertices(blocked.begin(), blocked.end());
+    for(auto& id: opened)
+        m_Graph.add_vertex(id);
+    m_Planner.remove_vertices(blocked.begin(), blocked.end());
+    m_Planner.add_vertices(opened.begin(), opened.end());
+
+    for(auto& id: blocked)
+        m_Map->setType(id, CellMap::Type::blocked);
+    for(auto& id: opened)
+        m_Map->setType(id, CellMap::Type::opened);
+    m_Map->flush();
+}
+
+void Grid::generationRandomWalls(const size_t count)
+{
+    setWalls(randomWalls(count));
 }
 
 void Grid::setSize(const size_t w, const size_t h)
@@ -45,48 +90,42 @@ void Grid::setSize(const size_t w, const size_t h)
 
 void Grid::setPoint(QPointF position)
 {
-    Cell* cell = static_cast<Cell*>(QGraphicsScene::itemAt(position, QTransform()));
+    if(m_Map == nullptr)
+        return;
+
+    // blocked cells cannot be selected
+    const size_t id = m_Map->cellAt(position);
+    if(id == m_Map->size() || !m_Graph.exist(id))
+        return;
 
     switch(m_numbSelectedCell)
     {
     case 0:
-        if(cell->setSelect())
-        {
-            m_selectedPoint.first = cell;
-            ++m_numbSelectedCell;
-            updatePredecessor();
-        }
+        m_selectedPoint.first = id;
+        ++m_numbSelectedCell;
         break;
     case 1:
-        if(cell != m_selectedPoint.first)
+        if(id != m_selectedPoint.first)
         {
-            if(cell->setSelect())
-            {
-                m_selectedPoint.second = cell;
-                ++m_numbSelectedCell;
-                showPath();
-            }
+            m_selectedPoint.second = id;
+            ++m_numbSelectedCell;
+            updatePredecessor();
         }
         else
         {
-            cell->setNotSelect();
-            m_selectedPoint.first = nullptr;
             --m_numbSelectedCell;
         }
         break;
     case 2:
-        if(cell == m_selectedPoint.second )
+        if(id == m_selectedPoint.second)
         {
             hidePath();
-            cell->setNotSelect();
-            m_selectedPoint.second  = nullptr;
             --m_numbSelectedCell;
+            updatePredecessor();
         }
-        else if(cell == m_selectedPoint.first)
+        else if(id == m_selectedPoint.first)
         {
             hidePath();
-            cell->setNotSelect();
-            m_selectedPoint.first = nullptr;
             std::swap(m_selectedPoint.first, m_selectedPoint.second);
             --m_numbSelectedCell;
             updatePredecessor();
@@ -95,13 +134,18 @@ void Grid::setPoint(QPointF position)
     default:
         break;
     }
+    updateMarkers();
 }
 
 void Grid::clear()
 {
     m_Graph.clear();
+    m_Planner.stop();
+    m_Path.clear();
     QGraphicsScene::clear();
-    m_selectedPoint.first = m_selectedPoint.second = nullptr;
+    m_Map = nullptr;
+    m_Markers.first = m_Markers.second = nullptr;
+    m_PathItem = nullptr;
     m_numbSelectedCell = 0;
 }
 
@@ -111,121 +155,106 @@ void Grid::build(const int width, const int height, const size_t numb_walls)
 
     setSize(width, height);
 
-    for(int row = 0; row < height; ++row)
+    // one item for all cells, the overlays above it
+    m_Map = new CellMap(QSize(width, height), m_sizeCell);
+    QGraphicsScene::addItem(m_Map);
+
+    m_PathItem = new QGraphicsPathItem;
+    m_PathItem->setPen(QPen(Qt::green, std::min(m_sizeCell.width(), m_sizeCell.height()) / 2.0, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    m_PathItem->setZValue(1);
+    QGraphicsScene::addItem(m_PathItem);
+
+    for(auto marker: {&m_Markers.first, &m_Markers.second})
     {
-        for(int column = 0; column < width; ++column)
-        {
-            const size_t id = row * width + column;
-
-            // create cell in scene
-            QPoint point(column * m_sizeCell.width() , row * m_sizeCell.height());
-            QGraphicsScene::addItem(new Cell(point, m_sizeCell, id, Cell::Type::opened));
-
-            // assign graph
-            m_Graph.add_vertex(id);
-            if(column > 0)
-                m_Graph.add_edge(id, id - 1, 1, 1);
-            if(row > 0)
-                m_Graph.add_edge(id, id - width, 1, 1);
-        }
+        *marker = new QGraphicsEllipseItem;
+        (*marker)->setPen(Qt::NoPen);
+        (*marker)->setBrush(QColor(Qt::red));
+        (*marker)->setZValue(2);
+        (*marker)->setVisible(false);
+        QGraphicsScene::addItem(*marker);
     }
 
-    m_Cells = this->items(Qt::SortOrder::AscendingOrder);
+    // assign graph, the planner gets a copy and then only the changed cells
+    m_Graph.assign(width, height);
+    m_Planner.assign(m_Graph);
+
     generationRandomWalls(numb_walls);
-    QGraphicsScene::update();
 }
 
 void Grid::update(const size_t numb_walls)
 {
-    this->hidePath();
-
-    std::vector<size_t> block_cells;
-
-    // look for blocked cells and reset from opened
-    for(auto& c: m_Cells)
-    {
-        Cell* cell = static_cast<Cell*>(c);
-
-        if(cell->getType() == Cell::Type::blocked)
-        {
-            block_cells.push_back(cell->id());
-            cell->setType(Cell::Type::opened);
-        }
-    }
-
-    const size_t width = this->width();
-    const size_t height = this->height();
-
-    // restore graph
-    for(auto& id: block_cells)
-    {
-        m_Graph.add_vertex(id);
-        const size_t column = id % width;
-        const size_t row = (id - column) / height;
-
-        // link left cell
-        if(column > 0)
-            m_Graph.add_edge(id, id - 1, 1, 1);
-        // link right cell
-        if(column < width - 1)
-            m_Graph.add_edge(id, id + 1, 1, 1);
-        // link top cell
-        if(row > 0)
-            m_Graph.add_edge(id, id - width, 1, 1);
-        // link bot cell
-        if(row < height - 1)
-            m_Graph.add_edge(id, id + width, 1, 1);
-    }
-
     generationRandomWalls(numb_walls);
     updatePredecessor();
-    showPath();
-
-    QGraphicsScene::update();
 }
 
 void Grid::mousePressEvent(QGraphicsSceneMouseEvent *event)
 {
-    QGraphicsScene::update();
     QGraphicsScene::mousePressEvent(event);
 
-    const QPointF position = event->pos();
+    const QPointF position = event->scenePos();
     setPoint(position);
 }
 
+// the search runs on the planner's thread and the path arrives in updatePath;
+// a new request cancels the one in progress
 void Grid::updatePredecessor()
 {
-    if(m_selectedPoint.first != nullptr)
-        m_Predecessor = Shortest_path_unchecked(m_Graph, m_selectedPoint.first->id());
+    if(m_numbSelectedCell == 2)
+    {
+        const size_t target = m_selectedPoint.second;
+        m_Planner.search(m_selectedPoint.first, target, heuristic_type(width(), target));
+    }
+    else
+    {
+        m_Planner.stop();
+    }
 }
 
-void Grid::updatePath()
+void Grid::updatePath(const size_t generation, path_type path)
 {
-    if(m_selectedPoint.second != nullptr)
-        Construct_shortest_path(m_selectedPoint.second->id(), m_Predecessor, m_Path);
+    // results overtaken by later clicks or walls are dropped
+    if(generation != m_Planner.generation() || m_numbSelectedCell != 2 || m_PathItem == nullptr)
+        return;
+
+    // an unchanged path is not invalidated again
+    if(path == m_Path)
+        return;
+
+    m_Path = std::move(path);
+    showPath();
 }
 
-void Grid::updateCells(std::list<size_t>::iterator first, std::list<size_t>::iterator last, QColor color)
+void Grid::updateMarkers()
 {
-    if(std::distance(first, last) > 1)
-    {
-        while(first != last)
-        {
-            static_cast<Cell*>(m_Cells[*first])->setColor(color);
-            ++first;
-        }
-    }
+    if(m_Map == nullptr)
+        return;
+
+    const auto place = [&](QGraphicsEllipseItem* marker, const size_t id, const bool visible) {
+        const QRectF cell = m_Map->cellRect(id);
+        const qreal rx = cell.width() / 6;
+        const qreal ry = cell.height() / 6;
+        marker->setRect(QRectF(cell.center().x() - rx, cell.center().y() - ry, 2 * rx, 2 * ry));
+        marker->setVisible(visible);
+    };
+    place(m_Markers.first, m_selectedPoint.first, m_numbSelectedCell > 0);
+    place(m_Markers.second, m_selectedPoint.second, m_numbSelectedCell > 1);
 }
 
 void Grid::showPath()
 {
-    updatePath();
-
-    if(m_selectedPoint.second != nullptr)
-        updateCells(m_Path.begin(), m_Path.end(), Qt::green);
+    // a line through the centres of the path cells
+    QPainterPath line;
+    if(m_Path.size() > 1)
+    {
+        line.moveTo(m_Map->cellRect(m_Path.front()).center());
+        for(auto& id: m_Path)
+            line.lineTo(m_Map->cellRect(id).center());
+    }
+    m_PathItem->setPath(line);
 }
 
 void Grid::hidePath()
 {
-    updateCells(m_Path.begin(), m_Path.end(), Qt::white);
+    m_Path.clear();
+    m_PathItem->setPath(QPainterPath());
 }
@@ -1,10 +1,14 @@
 #pragma once
-#include "cell.hpp"
-#include "graph.hpp"
-#include "shortest_path.hpp"
-#include <set>
+#include "cell_map.hpp"
+#include "grid_graph.hpp"
+#include "astar.hpp"
+#include "async_planner.hpp"
+#include <random>
 #include <list>
+#include <cstdint>
 #include <QGraphicsScene>
+#include <QGraphicsEllipseItem>
+#include <QGraphicsPathItem>
 #include <QRandomGenerator>
 #include <QGraphicsSceneMouseEvent>
 
@@ -13,6 +17,11 @@ constexpr QSize DEFAULT_SIZE_CELL(40,40);
 class Grid final: public QGraphicsScene
 {
     Q_OBJECT
+    // 32-bit ids and 8-bit steps halve the search state; path lengths are summed as int
+    using graph_type = Grid_graph<std::uint32_t, std::uint8_t>;
+    using heuristic_type = Manhattan_heuristic<graph_type::label_type, distance_type<graph_type::weight_type>>;
+    using planner_type = Async_planner<graph_type, heuristic_type>;
+    using path_type = std::list<graph_type::label_type>;
 public:
     Grid(QObject* parent = nullptr);
     Grid(const QRectF sceneRect, QObject* parent = nullptr);
@@ -31,21 +40,29 @@ protected:
     void setSize(const size_t w, const size_t h);
     void setPoint(QPointF position);
     void updatePredecessor();
-    void updatePath();
-    void updateCells(std::list<size_t>::iterator first, std::list<size_t>::iterator last, QColor color);
+    void updatePath(const size_t generation, path_type path);
+    void updateMarkers();
     void showPath();
     void hidePath();
+    std::vector<bool> randomWalls(const size_t count) const;
+    void setWalls(const std::vector<bool>& walls);
     void generationRandomWalls(const size_t count);
 
 private:
     QSize m_sizeCell = DEFAULT_SIZE_CELL;
     QSize m_sizeGrid;
-    QList<QGraphicsItem*> m_Cells;
 
-    QPair<Cell*, Cell*> m_selectedPoint;
+    // the cells are one item; markers and path are drawn over it
+    CellMap* m_Map = nullptr;
+    QPair<QGraphicsEllipseItem*, QGraphicsEllipseItem*> m_Markers;
+    QGraphicsPathItem* m_PathItem = nullptr;
+
+    // ids of the selected cells, valid up to m_numbSelectedCell
+    QPair<size_t, size_t> m_selectedPoint;
     size_t m_numbSelectedCell = 0;
 
-    Graph<size_t, size_t> m_Graph;
-    Predecessor<size_t> m_Predecessor;
-    std::list<size_t> m_Path;
+    graph_type m_Graph;
+    path_type m_Path;
+    // searches run on the planner's thread; declared last so it stops first
+    planner_type m_Planner;
 };
@@ -0,0 +1,218 @@
+#pragma once
+#include "graph.hpp"
+#include <vector>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+// 4-connected grid with unit weights. Vertex ids are row * width + column and
+// the neighbours are computed from the passability map, so no adjacency is stored.
+// Label may be narrower than size_t (uint32_t halves predecessor maps); assign()
+// rejects grids whose ids would not fit below its maximum, which is kept free
+// as the "no vertex" value.
+template<class Label = size_t, class Weight = size_t>
+class Grid_graph {
+    static_assert(std::is_integral<Label>::value, "Type Label is not integral.");
+
+public:
+    using label_type = Label;
+    using weight_type = Weight;
+
+    using edge_type = Edge<label_type, weight_type>;
+    using size_type = size_t;
+
+    class edge_const_iterator
+    {
+        void skip()
+        {
+            while (m_Direction < 4 && !m_Graph->neighbor(m_Vertex, m_Direction, m_Target))
+                ++m_Direction;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = edge_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const edge_type*;
+        using reference = edge_type;
+
+        edge_const_iterator() = default;
+
+        edge_const_iterator(const Grid_graph* graph, const label_type& vertex, int direction)
+            : m_Graph(graph), m_Vertex(vertex), m_Direction(direction)
+        {
+            skip();
+        }
+
+        edge_type operator*() const { return edge_type(m_Target, static_cast<weight_type>(1)); }
+
+        edge_const_iterator& operator++()
+        {
+            ++m_Direction;
+            skip();
+            return *this;
+        }
+        edge_const_iterator operator++(int)
+        {
+            edge_const_iterator old = *this;
+            ++(*this);
+            return old;
+        }
+
+        bool operator==(const edge_const_iterator& other) const { return m_Direction == other.m_Direction; }
+        bool operator!=(const edge_const_iterator& other) const { return m_Direction != other.m_Direction; }
+
+    private:
+        const Grid_graph* m_Graph = nullptr;
+        label_type m_Vertex = label_type();
+        label_type m_Target = label_type();
+        int m_Direction = 4;
+    };
+
+    using map_const_iterator = edge_const_iterator;
+
+    Grid_graph() = default;
+
+    Grid_graph(const size_type width, const size_type height)
+    {
+        assign(width, height);
+    }
+
+    void assign(const size_type width, const size_type height)
+    {
+        const auto limit = static_cast<size_type>(std::numeric_limits<label_type>::max());
+        if (width != 0 && height > limit / width)
+            throw std::length_error("Grid_graph::assign: too many cells for the label type");
+
+        m_Width = width;
+        m_Height = height;
+        m_Opened.assign(width * height, 1);
+        m_Size = width * height;
+    }
+
+    auto add_vertex(const label_type& vertex)
+    {
+        const bool inserted = in_range(vertex) && !m_Opened[vertex];
+        if (inserted)
+        {
+            m_Opened[vertex] = 1;
+            ++m_Size;
+        }
+        return inserted;
+    }
+    void remove_vertex(const label_type& vertex)
+    {
+        if (exist(vertex))
+        {
+            m_Opened[vertex] = 0;
+            --m_Size;
+        }
+    }
+
+    template<class InputIterator>
+    void remove_vertices(InputIterator First, InputIterator Last)
+    {
+        for (; First != Last; ++First)
+            remove_vertex(*First);
+    }
+
+    bool exist(const label_type& vertex) const
+    {
+        return in_range(vertex) && m_Opened[vertex];
+    }
+
+    bool has_edge(const label_type& from, const label_type& to) const
+    {
+        if (exist(from) && exist(to))
+        {
+            for (int direction = 0; direction < 4; ++direction)
+            {
+                label_type target;
+                if (neighbor(from, direction, target) && target == to)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    size_type width() const { return m_Width; }
+    size_type height() const { return m_Height; }
+    size_type cells() const { return m_Opened.size(); }
+    size_type size() const { return m_Size; }
+
+    void clear()
+    {
+        m_Opened.clear();
+        m_Width = m_Height = m_Size = 0;
+    }
+
+    template<class Function>
+    void for_each_vertex(Function function) const
+    {
+        for (size_type vertex = 0; vertex < m_Opened.size(); ++vertex)
+        {
+            if (m_Opened[vertex])
+                function(static_cast<label_type>(vertex));
+        }
+    }
+
+    // also valid for a blocked cell: it lists the open cells next to it
+    map_const_iterator map_cbegin(const label_type& vertex) const
+    {
+        return map_const_iterator(this, vertex, 0);
+    }
+    map_const_iterator map_cend(const label_type& vertex) const
+    {
+        return map_const_iterator(this, vertex, 4);
+    }
+
+    // 0 - left, 1 - right, 2 - top, 3 - bottom
+    bool neighbor(const label_type& vertex, const int direction, label_type& result) const
+    {
+        const size_type column = static_cast<size_type>(vertex) % m_Width;
+
+        switch (direction)
+        {
+        case 0:
+            if (column == 0)
+                return false;
+            result = vertex - 1;
+            break;
+        case 1:
+            if (column + 1 == m_Width)
+                return false;
+            result = vertex + 1;
+            break;
+        case 2:
+            if (static_cast<size_type>(vertex) < m_Width)
+                return false;
+            result = vertex - m_Width;
+            break;
+        case 3:
+            if (static_cast<size_type>(vertex) + m_Width >= m_Opened.size())
+                return false;
+            result = vertex + m_Width;
+            break;
+        default:
+            return false;
+        }
+        return m_Opened[result] != 0;
+    }
+
+private:
+    bool in_range(const label_type& vertex) const
+    {
+        return static_cast<size_type>(vertex) < m_Opened.size();
+    }
+
+    size_type m_Width = 0;
+    size_type m_Height = 0;
+    size_type m_Size = 0;
+    std::vector<unsigned char> m_Opened;
+};
+
+template<class Label, class Weight>
+struct is_graph<Grid_graph<Label, Weight>> : std::true_type {};
+
+template<class Label, class Weight>
+struct has_dense_labels<Grid_graph<Label, Weight>> : std::true_type {};
@@ -0,0 +1,280 @@
+#pragma once
+#include "visitor.hpp"
+#include "grid_graph.hpp"
+#include <list>
+#include <cstdlib>
+#include <cstdint>
+
+// Jump Point Search for the 4-connected, uniform-cost Grid_graph. Straight runs
+// of cells are skipped until a forced neighbour, the target, or (on vertical
+// runs) a horizontal jump point is found. The target-independent part of every
+// jump is precomputed per cell and direction (JPS+), so a jump is a table lookup
+// plus a check for the target; call update() after the graph changes. The state
+// is stamped, so one object can answer many queries on the same graph.
+template<class Label = size_t, class Weight = size_t>
+class Jump_point_search
+{
+public:
+    using label_type = Label;
+    using weight_type = distance_type<Weight>;
+    using graph_type = Grid_graph<label_type, Weight>;
+    using edge_type = Edge<label_type, weight_type>;
+    using queue_type = std::priority_queue<edge_type, std::vector<edge_type>, std::greater<edge_type>>;
+
+    Jump_point_search() = delete;
+
+    explicit Jump_point_search(const graph_type& graph)
+        : m_Graph(graph)
+    {
+        update();
+    }
+
+    // rebuilds the jump tables from the current passability map
+    void update()
+    {
+        const long width = static_cast<long>(m_Graph.width());
+        const long height = static_cast<long>(m_Graph.height());
+        for (auto& table : m_Jump)
+            table.assign(m_Graph.cells(), 0);
+
+        // passability with a blocked border, so the scans below need no bounds checks
+        const long stride = width + 2;
+        std::vector<unsigned char> opened(static_cast<size_t>(stride * (height + 2)), 0);
+        for (long y = 0; y < height; ++y)
+        {
+            for (long x = 0; x < width; ++x)
+                opened[(y + 1) * stride + x + 1] = m_Graph.exist(id(x, y));
+        }
+        const auto open = [&](const long x, const long y) { return opened[(y + 1) * stride + x + 1] != 0; };
+
+        // entry of the cell before (x, y) in a direction, given the entry of (x, y) itself
+        const auto step = [&](const long x, const long y, const int direction, const bool stop) -> jump_type {
+            if (!open(x, y))
+                return 0;
+            if (stop)
+                return 1;
+            const auto next = m_Jump[direction][id(x, y)];
+            return next > 0 ? next + 1 : next - 1;
+        };
+        const auto horizontal_forced = [&](const long x, const long y, const long dx) {
+            return (open(x, y - 1) && !open(x - dx, y - 1)) || (open(x, y + 1) && !open(x - dx, y + 1));
+        };
+        // a vertical scan also stops where a horizontal scan would find a jump point
+        const auto vertical_stop = [&](const long x, const long y, const long dy) {
+            return (open(x - 1, y) && !open(x - 1, y - dy)) || (open(x + 1, y) && !open(x + 1, y - dy))
+                || m_Jump[left][id(x, y)] > 0 || m_Jump[right][id(x, y)] > 0;
+        };
+
+        for (long y = 0; y < height; ++y)
+        {
+            for (long x = width - 1; x >= 0; --x)
+                m_Jump[right][id(x, y)] = step(x + 1, y, right, horizontal_forced(x + 1, y, 1));
+            for (long x = 0; x < width; ++x)
+                m_Jump[left][id(x, y)] = step(x - 1, y, left, horizontal_forced(x - 1, y, -1));
+        }
+        for (long y = height - 1; y >= 0; --y)
+        {
+            for (long x = 0; x < width; ++x)
+                m_Jump[down][id(x, y)] = step(x, y + 1, down, open(x, y + 1) && vertical_stop(x, y + 1, 1));
+        }
+        for (long y = 0; y < height; ++y)
+        {
+            for (long x = 0; x < width; ++x)
+                m_Jump[up][id(x, y)] = step(x, y - 1, up, open(x, y - 1) && vertical_stop(x, y - 1, -1));
+        }
+    }
+
+    std::list<label_type> shortest_path(const label_type& source, const label_type& target)
+    {
+        std::list<label_type> path;
+        if (!m_Graph.exist(source) || !m_Graph.exist(target) || source == target)
+            return path;
+
+        reset(source, target);
+        while (!m_Queue.empty())
+        {
+            const edge_type processed_vertex = m_Queue.top();
+            m_Queue.pop();
+
+            const auto vertex = processed_vertex.target();
+            if (m_Color.at(vertex) == color_type::black)
+                continue;
+            m_Color[vertex] = color_type::black;
+
+            if (vertex == target)
+            {
+                construct_path(target, path);
+                break;
+            }
+            expand(vertex);
+        }
+        return path;
+    }
+
+private:
+    long column(const label_type& vertex) const { return static_cast<long>(static_cast<size_t>(vertex) % m_Graph.width()); }
+    long row(const label_type& vertex) const { return static_cast<long>(static_cast<size_t>(vertex) / m_Graph.width()); }
+    label_type id(const long x, const long y) const { return static_cast<label_type>(static_cast<size_t>(y) * m_Graph.width() + static_cast<size_t>(x)); }
+
+    weight_type estimate(const long x, const long y) const
+    {
+        return static_cast<weight_type>(std::labs(x - m_TargetX) + std::labs(y - m_TargetY));
+    }
+
+    void reset(const label_type& source, const label_type& target)
+    {
+        m_Distance.reset(std::numeric_limits<weight_type>::max());
+        m_Predecessor.reset(std::numeric_limits<label_type>::max());
+        m_Color.reset(color_type::white);
+        clear_queue(m_Queue);
+
+        m_TargetX = column(target);
+        m_TargetY = row(target);
+
+        m_Distance[source] = static_cast<weight_type>(0);
+        m_Color[source] = color_type::gray;
+        m_Queue.emplace(source, estimate(column(source), row(source)));
+    }
+
+    // m_Jump[direction][cell] describes the scan that starts next to cell:
+    // d > 0 - the first jump point is d cells away,
+    // d <= 0 - there is none and -d open cells lie before the wall
+    enum { left, right, up, down };
+    using jump_type = std::int32_t;
+
+    static int direction_of(const long dx, const long dy)
+    {
+        return dx < 0 ? left : dx > 0 ? right : dy < 0 ? up : down;
+    }
+
+    // whether a scan from (x, y) toward column target_x reaches it before a wall
+    bool sees_column(const long x, const long y, const long target_x) const
+    {
+        if (target_x == x)
+            return true;
+        const auto entry = m_Jump[target_x < x ? left : right][id(x, y)];
+        return std::labs(target_x - x) <= std::labs(entry);
+    }
+
+    // jumps from (x, y) in direction (dx, dy) and returns whether a jump point was found
+    bool jump(const long x, const long y, const long dx, const long dy, long& jump_x, long& jump_y) const
+    {
+        const auto entry = m_Jump[direction_of(dx, dy)][id(x, y)];
+        const long reach = std::labs(entry);
+
+        // the target is a jump point too when the scan passes it, or on a vertical
+        // scan, when it lies in the row of a passed cell and is visible from there
+        const long along = dx != 0 ? (m_TargetX - x) * dx : (m_TargetY - y) * dy;
+        if (along > 0 && along <= reach)
+        {
+            const bool seen = dx != 0 ? m_TargetY == y : sees_column(x, m_TargetY, m_TargetX);
+            if (seen)
+            {
+                jump_x = dx != 0 ? m_TargetX : x;
+                jump_y = dx != 0 ? y : m_TargetY;
+                return true;
+            }
+        }
+
+        if (entry <= 0)
+            return false;
+        jump_x = x + dx * entry;
+        jump_y = y + dy * entry;
+        return true;
+    }
+
+    void expand(const label_type& vertex)
+    {
+        const long x = column(vertex);
+        const long y = row(vertex);
+        const auto parent = m_Predecessor.at(vertex);
+
+        long directions[4][2];
+        int count = 0;
+        if (parent == std::numeric_limits<label_type>::max())
+        {
+            const long all[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+            for (const auto& direction : all)
+            {
+                directions[count][0] = direction[0];
+                directions[count][1] = direction[1];
+                ++count;
+            }
+        }
+        else
+        {
+            const long dx = (x > column(parent)) - (x < column(parent));
+            const long dy = (y > row(parent)) - (y < row(parent));
+            // keep going straight and allow both perpendicular turns
+            directions[count][0] = dx; directions[count][1] = dy; ++count;
+            directions[count][0] = dy; directions[count][1] = dx; ++count;
+            directions[count][0] = -dy; directions[count][1] = -dx; ++count;
+        }
+
+        const auto distance = m_Distance.at(vertex);
+        for (int direction = 0; direction < count; ++direction)
+        {
+            const long dx = directions[direction][0];
+            const long dy = directions[direction][1];
+
+            long jump_x, jump_y;
+            if (!jump(x, y, dx, dy, jump_x, jump_y))
+                continue;
+
+            const auto jump_point = id(jump_x, jump_y);
+            if (m_Color.at(jump_point) == color_type::black)
+                continue;
+
+            const auto total_distance = distance + static_cast<weight_type>(std::labs(jump_x - x) + std::labs(jump_y - y));
+            if (total_distance < m_Distance.at(jump_point))
+            {
+                m_Distance[jump_point] = total_distance;
+                m_Predecessor[jump_point] = vertex;
+                m_Color[jump_point] = color_type::gray;
+                m_Queue.emplace(jump_point, total_distance + estimate(jump_x, jump_y));
+            }
+        }
+    }
+
+    // fills in the straight runs between consecutive jump points
+    void construct_path(const label_type& target, std::list<label_type>& path) const
+    {
+        path.push_front(target);
+        for (auto vertex = target; m_Predecessor.at(vertex) != std::numeric_limits<label_type>::max(); )
+        {
+            const auto parent = m_Predecessor.at(vertex);
+            const long dx = (column(parent) > column(vertex)) - (column(parent) < column(vertex));
+            const long dy = (row(parent) > row(vertex)) - (row(parent) < row(vertex));
+
+            long x = column(vertex);
+            long y = row(vertex);
+            do
+            {
+                x += dx;
+                y += dy;
+                path.push_front(id(x, y));
+            } while (id(x, y) != parent);
+
+            vertex = parent;
+        }
+    }
+
+    const graph_type& m_Graph;
+
+    Stamped_map<label_type, weight_type> m_Distance;
+    Stamped_map<label_type, label_type> m_Predecessor;
+    Stamped_map<label_type, color_type> m_Color;
+    queue_type m_Queue;
+    std::vector<jump_type> m_Jump[4];
+
+    long m_TargetX = 0;
+    long m_TargetY = 0;
+};
+
+// builds the jump tables for a single query; keep a Jump_point_search for many
+template<class _Label, class _Weight>
+auto Jump_point_shortest_path(const Grid_graph<_Label, _Weight>& graph, const _Label& source, const _Label& target)
+{
+    Jump_point_search<_Label, _Weight> search(graph);
+    return search.shortest_path(source, target);
+}
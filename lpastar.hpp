@@ -0,0 +1,236 @@
+#pragma once
+#include "visitor.hpp"
+#include "cancellation.hpp"
+#include <list>
+#include <tuple>
+
+// Lifelong Planning A*: keeps the g-values of the last search between graph
+// changes and repairs only the vertices whose distance is affected. After the
+// graph changes, call update_vertex for every vertex whose incoming edges
+// changed (an added or removed vertex and its successors), then
+// compute_shortest_path again. Labels must be integral, weights non-negative
+// and the heuristic consistent.
+template<class GraphType, class Heuristic>
+class LPAStar_planner
+{
+public:
+    using label_type = typename GraphType::label_type;
+    using weight_type = distance_type<typename GraphType::weight_type>;
+    using graph_type = GraphType;
+    using heuristic_type = Heuristic;
+    using key_type = std::pair<weight_type, weight_type>;
+
+    static_assert(std::is_integral<label_type>::value, "Type Label is not integral.");
+
+    LPAStar_planner() = delete;
+
+    // reverse_graph must hold the edges of graph reversed; it may be graph itself
+    LPAStar_planner(const graph_type& graph, const graph_type& reverse_graph)
+        : m_Graph(graph), m_ReverseGraph(reverse_graph)
+    {
+
+    }
+
+    void reset(const label_type& source, const label_type& target, const heuristic_type& heuristic)
+    {
+        m_Source = source;
+        m_Target = target;
+        m_Heuristic = heuristic;
+        m_Active = true;
+
+        m_G.reset(infinity());
+        m_Rhs.reset(infinity());
+        m_Queued.reset(unqueued());
+        clear_queue(m_Queue);
+
+        update_vertex(source);
+    }
+
+    void clear()
+    {
+        m_Active = false;
+        m_G.reset(infinity());
+        m_Rhs.reset(infinity());
+        m_Queued.reset(unqueued());
+        clear_queue(m_Queue);
+    }
+
+    bool active() const { return m_Active; }
+    label_type source() const { return m_Source; }
+    label_type target() const { return m_Target; }
+
+    // number of vertices expanded by the last compute_shortest_path
+    size_t expanded() const { return m_Expanded; }
+
+    void update_vertex(const label_type& vertex)
+    {
+        if (!m_Active)
+            return;
+
+        if (vertex == m_Source)
+        {
+            m_Rhs[vertex] = m_Graph.exist(vertex) ? static_cast<weight_type>(0) : infinity();
+        }
+        else
+        {
+            weight_type best = infinity();
+            if (m_Graph.exist(vertex))
+            {
+                std::for_each(m_ReverseGraph.map_cbegin(vertex), m_ReverseGraph.map_cend(vertex),
+                    [&](const auto& neighbor) {
+                        const auto distance = m_G.at(neighbor.target());
+                        if (distance != infinity() && m_Graph.exist(neighbor.target()) && distance + neighbor.weight() < best)
+                            best = distance + neighbor.weight();
+                    });
+            }
+            m_Rhs[vertex] = best;
+        }
+
+        if (m_G.at(vertex) != m_Rhs.at(vertex))
+        {
+            const auto key = calculate_key(vertex);
+            if (m_Queued.at(vertex) != key)
+            {
+                m_Queued[vertex] = key;
+                m_Queue.emplace(key.first, key.second, vertex);
+            }
+        }
+        else
+        {
+            m_Queued[vertex] = unqueued();
+        }
+    }
+
+    template<class InputIterator>
+    void update_vertices(InputIterator First, InputIterator Last)
+    {
+        for (; First != Last; ++First)
+            update_vertex(*First);
+    }
+
+    void compute_shortest_path()
+    {
+        compute_shortest_path(Cancellation_token());
+    }
+
+    // false if the token was set first; the state stays consistent, so a later
+    // call (after further updates) carries on from where this one stopped
+    bool compute_shortest_path(const Cancellation_token& token)
+    {
+        m_Expanded = 0;
+        if (!m_Active)
+            return true;
+
+        while (true)
+        {
+            if (token.cancelled())
+                return false;
+
+            discard_stale();
+            if (m_Queue.empty())
+                break;
+
+            const auto& top = m_Queue.top();
+            const key_type top_key(std::get<0>(top), std::get<1>(top));
+            if (!(top_key < calculate_key(m_Target)) && m_Rhs.at(m_Target) == m_G.at(m_Target))
+                break;
+
+            const auto vertex = std::get<2>(top);
+            m_Queue.pop();
+            m_Queued[vertex] = unqueued();
+            ++m_Expanded;
+
+            if (m_G.at(vertex) > m_Rhs.at(vertex))
+            {
+                m_G[vertex] = m_Rhs.at(vertex);
+            }
+            else
+            {
+                m_G[vertex] = infinity();
+                update_vertex(vertex);
+            }
+
+            if (m_Graph.exist(vertex))
+            {
+                std::for_each(m_Graph.map_cbegin(vertex), m_Graph.map_cend(vertex),
+                    [&](const auto& neighbor) {
+                        update_vertex(neighbor.target());
+                    });
+            }
+        }
+        return true;
+    }
+
+    weight_type distance(const label_type& vertex) const { return m_G.at(vertex); }
+
+    // follows the cheapest consistent predecessors back from the target; empty if unreachable
+    std::list<label_type> shortest_path() const
+    {
+        std::list<label_type> path;
+        if (!m_Active || m_G.at(m_Target) == infinity() || m_Source == m_Target)
+            return path;
+
+        path.push_front(m_Target);
+        for (auto vertex = m_Target; vertex != m_Source; )
+        {
+            auto best = infinity();
+            auto parent = vertex;
+            std::for_each(m_ReverseGraph.map_cbegin(vertex), m_ReverseGraph.map_cend(vertex),
+                [&](const auto& neighbor) {
+                    const auto distance = m_G.at(neighbor.target());
+                    if (distance != infinity() && m_Graph.exist(neighbor.target()) && distance + neighbor.weight() < best)
+                    {
+                        best = distance + neighbor.weight();
+                        parent = neighbor.target();
+                    }
+                });
+            if (parent == vertex)
+                return std::list<label_type>();
+
+            vertex = parent;
+            path.push_front(vertex);
+        }
+        return path;
+    }
+
+private:
+    using entry_type = std::tuple<weight_type, weight_type, label_type>;
+    using queue_type = std::priority_queue<entry_type, std::vector<entry_type>, std::greater<entry_type>>;
+
+    static weight_type infinity() { return std::numeric_limits<weight_type>::max(); }
+    static key_type unqueued() { return key_type(infinity(), infinity()); }
+
+    key_type calculate_key(const label_type& vertex) const
+    {
+        const auto distance = std::min(m_G.at(vertex), m_Rhs.at(vertex));
+        if (distance == infinity())
+            return unqueued();
+        return key_type(distance + m_Heuristic(vertex), distance);
+    }
+
+    // an entry is live while its key is the one recorded for its vertex
+    void discard_stale()
+    {
+        while (!m_Queue.empty())
+        {
+            const auto& top = m_Queue.top();
+            if (m_Queued.at(std::get<2>(top)) == key_type(std::get<0>(top), std::get<1>(top)))
+                break;
+            m_Queue.pop();
+        }
+    }
+
+    const graph_type& m_Graph;
+    const graph_type& m_ReverseGraph;
+    heuristic_type m_Heuristic;
+
+    label_type m_Source = label_type();
+    label_type m_Target = label_type();
+    bool m_Active = false;
+    size_t m_Expanded = 0;
+
+    Stamped_map<label_type, weight_type> m_G;
+    Stamped_map<label_type, weight_type> m_Rhs;
+    Stamped_map<label_type, key_type> m_Queued;
+    queue_type m_Queue;
+};
@@ -1,5 +1,5 @@
 #pragma once
-#include "cell.hpp"
+#include "cell_map.hpp"
 #include "grid.hpp"
 #include <QMainWindow>
 #include <QGraphicsScene>
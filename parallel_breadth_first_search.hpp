@@ -0,0 +1,278 @@
+#pragma once
+#include "visitor.hpp"
+#include "grid_graph.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <cstdint>
+
+// One bit per vertex label; set() may be called concurrently.
+class Atomic_bitmap
+{
+public:
+    using word_type = std::uint64_t;
+    static const size_t word_bits = 64;
+
+    explicit Atomic_bitmap(const size_t size)
+        : m_Words((size + word_bits - 1) / word_bits)
+    {
+        for (auto& word : m_Words)
+            word.store(0, std::memory_order_relaxed);
+    }
+
+    bool test(const size_t index) const
+    {
+        return (m_Words[index / word_bits].load(std::memory_order_relaxed) >> (index % word_bits)) & 1;
+    }
+
+    // returns whether the bit was clear before
+    bool set(const size_t index)
+    {
+        const word_type mask = word_type(1) << (index % word_bits);
+        if (m_Words[index / word_bits].load(std::memory_order_relaxed) & mask)
+            return false;
+        return !(m_Words[index / word_bits].fetch_or(mask, std::memory_order_relaxed) & mask);
+    }
+
+    // index of the lowest set bit of a non-zero word
+    static size_t lowest(const word_type word)
+    {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_ctzll(word));
+#else
+        size_t index = 0;
+        for (auto bits = word; !(bits & 1); bits >>= 1)
+            ++index;
+        return index;
+#endif
+    }
+
+    word_type word(const size_t index) const { return m_Words[index].load(std::memory_order_relaxed); }
+    void clear_word(const size_t index) { m_Words[index].store(0, std::memory_order_relaxed); }
+    size_t words() const { return m_Words.size(); }
+
+private:
+    std::vector<std::atomic<word_type>> m_Words;
+};
+
+// Reverse adjacency of a Graph read from its incoming-edge index instead of a
+// transpose() copy. An edge yields its source as target() and no weight, which
+// is all the bottom-up step looks at.
+template<class GraphType>
+class Incoming_view
+{
+public:
+    using label_type = typename GraphType::label_type;
+    using weight_type = typename GraphType::weight_type;
+    using edge_type = Edge<label_type, weight_type>;
+    using source_iterator = decltype(std::declval<const GraphType&>().incoming_cbegin(std::declval<label_type>()));
+
+    class map_const_iterator
+    {
+    public:
+        explicit map_const_iterator(const source_iterator& iterator)
+            : m_Iterator(iterator)
+        {
+
+        }
+
+        edge_type operator*() const { return edge_type(*m_Iterator, weight_type()); }
+
+        map_const_iterator& operator++()
+        {
+            ++m_Iterator;
+            return *this;
+        }
+
+        bool operator==(const map_const_iterator& other) const { return m_Iterator == other.m_Iterator; }
+        bool operator!=(const map_const_iterator& other) const { return m_Iterator != other.m_Iterator; }
+
+    private:
+        source_iterator m_Iterator;
+    };
+
+    explicit Incoming_view(const GraphType& graph)
+        : m_Graph(graph)
+    {
+
+    }
+
+    bool exist(const label_type& vertex) const { return m_Graph.exist(vertex); }
+
+    map_const_iterator map_cbegin(const label_type& vertex) const { return map_const_iterator(m_Graph.incoming_cbegin(vertex)); }
+    map_const_iterator map_cend(const label_type& vertex) const { return map_const_iterator(m_Graph.incoming_cend(vertex)); }
+
+private:
+    const GraphType& m_Graph;
+};
+
+// Level-synchronous BFS that expands the frontier top-down (frontier vertices
+// claim unvisited neighbours) while it is small, and bottom-up (unvisited vertices
+// look for a parent in the frontier over reverse_graph) while it is large.
+// Labels must be integral and dense. Distances are hop counts.
+template<class _Graph, class _ReverseGraph>
+auto Parallel_breadth_first_search(const _Graph& graph, const _ReverseGraph& reverse_graph, const typename _Graph::label_type& source, Thread_pool& pool)
+{
+    using label_type = typename _Graph::label_type;
+    using weight_type = distance_type<typename _Graph::weight_type>;
+
+    static_assert(std::is_integral<label_type>::value, "Type Label is not integral.");
+
+    // switching thresholds from Beamer et al.
+    const size_t alpha = 14;
+    const size_t beta = 24;
+    const size_t chunk = 256;
+    const auto none = std::numeric_limits<label_type>::max();
+
+    size_t bound = 0;
+    graph.for_each_vertex(
+        [&](const auto& label) {
+            bound = std::max(bound, static_cast<size_t>(label) + 1);
+        }
+    );
+
+    Index_map<label_type, label_type> predecessor(bound, none);
+    Index_map<label_type, weight_type> distance(bound, std::numeric_limits<weight_type>::max());
+    const auto degree = [&](const label_type& vertex) {
+        return static_cast<size_t>(std::distance(graph.map_cbegin(vertex), graph.map_cend(vertex)));
+    };
+
+    if (graph.exist(source))
+    {
+        Atomic_bitmap visited(bound);
+        Atomic_bitmap frontier_bits(bound);
+        Atomic_bitmap next_bits(bound);
+        std::vector<label_type> frontier(1, source);
+        std::vector<std::vector<label_type>> next(pool.size());
+        std::vector<size_t> counts(pool.size());
+        std::vector<size_t> awakened(pool.size());
+
+        size_t unexplored_edges = 0;
+        graph.for_each_vertex(
+            [&](const auto& label) {
+                unexplored_edges += degree(label);
+            }
+        );
+
+        visited.set(static_cast<size_t>(source));
+        distance[source] = static_cast<weight_type>(0);
+        size_t frontier_edges = degree(source);
+        size_t frontier_size = 1;
+        unexplored_edges -= frontier_edges;
+        bool top_down = true;
+
+        for (weight_type level = 1; frontier_size != 0; ++level)
+        {
+            if (top_down && frontier_edges > unexplored_edges / alpha)
+            {
+                for (const auto& vertex : frontier)
+                    frontier_bits.set(static_cast<size_t>(vertex));
+                top_down = false;
+            }
+            else if (!top_down && frontier_size < bound / beta)
+            {
+                frontier.clear();
+                for (size_t word = 0; word < frontier_bits.words(); ++word)
+                {
+                    for (auto bits = frontier_bits.word(word); bits != 0; bits &= bits - 1)
+                        frontier.push_back(static_cast<label_type>(word * Atomic_bitmap::word_bits + Atomic_bitmap::lowest(bits)));
+                    frontier_bits.clear_word(word);
+                }
+                top_down = true;
+            }
+
+            std::fill(counts.begin(), counts.end(), 0);
+            if (top_down)
+            {
+                pool.parallel_for((frontier.size() + chunk - 1) / chunk,
+                    [&](const size_t block, const size_t thread) {
+                        for (size_t index = block * chunk; index < std::min(frontier.size(), (block + 1) * chunk); ++index)
+                        {
+                            const auto vertex = frontier[index];
+                            std::for_each(graph.map_cbegin(vertex), graph.map_cend(vertex),
+                                [&](const auto& neighbor) {
+                                    const auto target = neighbor.target();
+                                    if (!visited.set(static_cast<size_t>(target)))
+                                        return;
+                                    predecessor[target] = vertex;
+                                    distance[target] = level;
+                                    next[thread].push_back(target);
+                                    counts[thread] += degree(target);
+                                });
+                        }
+                    });
+
+                frontier.clear();
+                for (auto& thread_next : next)
+                {
+                    frontier.insert(frontier.end(), thread_next.begin(), thread_next.end());
+                    thread_next.clear();
+                }
+                frontier_size = frontier.size();
+            }
+            else
+            {
+                // every thread owns whole words, so the bitmaps of a word are written by one thread
+                pool.parallel_for((visited.words() + chunk - 1) / chunk,
+                    [&](const size_t block, const size_t thread) {
+                        for (size_t word = block * chunk; word < std::min(visited.words(), (block + 1) * chunk); ++word)
+                        {
+                            for (auto bits = ~visited.word(word); bits != 0; bits &= bits - 1)
+                            {
+                                const size_t index = word * Atomic_bitmap::word_bits + Atomic_bitmap::lowest(bits);
+                                const auto vertex = static_cast<label_type>(index);
+                                if (index >= bound || !graph.exist(vertex))
+                                    continue;
+
+                                for (auto First = reverse_graph.map_cbegin(vertex), Last = reverse_graph.map_cend(vertex); First != Last; ++First)
+                                {
+                                    const auto parent = (*First).target();
+                                    if (!frontier_bits.test(static_cast<size_t>(parent)))
+                                        continue;
+                                    predecessor[vertex] = parent;
+                                    distance[vertex] = level;
+                                    visited.set(index);
+                                    next_bits.set(index);
+                                    counts[thread] += degree(vertex);
+                                    ++awakened[thread];
+                                    break;
+                                }
+                            }
+                        }
+                    });
+
+                frontier_size = 0;
+                for (auto& count : awakened)
+                {
+                    frontier_size += count;
+                    count = 0;
+                }
+                std::swap(frontier_bits, next_bits);
+                for (size_t word = 0; word < next_bits.words(); ++word)
+                    next_bits.clear_word(word);
+            }
+
+            frontier_edges = 0;
+            for (const auto& count : counts)
+                frontier_edges += count;
+            unexplored_edges -= std::min(unexplored_edges, frontier_edges);
+        }
+    }
+
+    return std::pair<Predecessor<label_type, Index_map<label_type, label_type>>, Distance<label_type, weight_type, Index_map<label_type, weight_type>>>(
+        std::piecewise_construct,
+        std::forward_as_tuple(std::move(predecessor)),
+        std::forward_as_tuple(std::move(distance)));
+}
+
+template<class _Label, class _Weight, class _Hasher, class _KeyEqual, class _Allocator>
+auto Parallel_breadth_first_search(const Graph<_Label, _Weight, _Hasher, _KeyEqual, _Allocator>& graph, const _Label& source, Thread_pool& pool)
+{
+    using graph_type = Graph<_Label, _Weight, _Hasher, _KeyEqual, _Allocator>;
+    return Parallel_breadth_first_search(graph, Incoming_view<graph_type>(graph), source, pool);
+}
+
+template<class _Label, class _Weight>
+auto Parallel_breadth_first_search(const Grid_graph<_Label, _Weight>& graph, const _Label& source, Thread_pool& pool)
+{
+    return Parallel_breadth_first_search(graph, graph, source, pool);
+}
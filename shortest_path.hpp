@@ -1,30 +1,80 @@
 #pragma once
 #include "breadth_first_search.hpp"
 
-template<class _Label, class _Weight, class _Visitor = Dijkstra_visitor<_Label, _Weight>>
-auto Shortest_path_unchecked(const Graph<_Label, _Weight>& graph, const _Label& source)
+template<class _Graph, class _Visitor = Dijkstra_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Graph>>
+auto Shortest_path_unchecked(const _Graph& graph, const typename _Graph::label_type& source)
 {
     _Visitor visitor(graph, source);
-    BFS_unchecked(graph, &visitor);
+    BFS_unchecked_static(graph, visitor);
     return visitor.predecessor();
 }
 
-template<class _Label, class Container>
-auto Construct_shortest_path(const _Label& target, const Predecessor<_Label>& pred, Container& container)
+// stops as soon as every vertex of [First, Last) is settled
+template<class _Graph, class _Visitor = Dijkstra_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Graph>, class _InputIterator>
+auto Shortest_path_unchecked(const _Graph& graph, const typename _Graph::label_type& source, _InputIterator First, _InputIterator Last)
+{
+    _Visitor visitor(graph, source);
+    visitor.add_targets(First, Last);
+    BFS_unchecked_static(graph, visitor);
+    return visitor.predecessor();
+}
+
+template<class _Graph, class _Visitor>
+void Shortest_path_unchecked(const _Graph& graph, const typename _Graph::label_type& source, _Visitor& workspace)
+{
+    workspace.reset(graph, source);
+    BFS_unchecked_static(graph, workspace);
+}
+
+template<class _Label, class _Predecessor, class Container>
+auto Construct_shortest_path(const _Label& target, const _Predecessor& pred, Container& container)
 {
     container.clear();
     for (auto vertex = target; vertex != pred.value_default(); vertex = pred.predecessor(vertex))
            container.push_front(vertex);
 }
 
-template<class _Label, class _Weight, class _Visitor = Dijkstra_visitor<_Label, _Weight>>
-auto Shortest_path(const Graph<_Label, _Weight>& graph, const _Label& source, const _Label& target)
+template<class _Graph, class _Visitor = Dijkstra_visitor<typename _Graph::label_type, distance_type<typename _Graph::weight_type>, _Graph>>
+auto Shortest_path(const _Graph& graph, const typename _Graph::label_type& source, const typename _Graph::label_type& target)
+{
+    using label_type = typename _Graph::label_type;
+
+    std::list<label_type> path;
+    if (graph.exist(source) && graph.exist(target) && source != target)
+    {
+        _Visitor visitor(graph, source);
+        visitor.add_target(target);
+        BFS_unchecked_static(graph, visitor);
+        Construct_shortest_path(target, visitor, path);
+    }
+    return path;
+}
+
+template<class _Graph, class _Visitor>
+auto Shortest_path(const _Graph& graph, const typename _Graph::label_type& source, const typename _Graph::label_type& target, _Visitor& workspace)
+{
+    std::list<typename _Graph::label_type> path;
+    if (graph.exist(source) && graph.exist(target) && source != target)
+    {
+        workspace.reset(graph, source);
+        workspace.add_target(target);
+        BFS_unchecked_static(graph, workspace);
+        Construct_shortest_path(target, workspace, path);
+    }
+    return path;
+}
+
+// empty if the token was set before the target was settled
+template<class _Graph, class _Visitor>
+auto Shortest_path(const _Graph& graph, const typename _Graph::label_type& source, const typename _Graph::label_type& target, _Visitor& workspace, const Cancellation_token& token)
 {
-    std::list<_Label> path;
+    std::list<typename _Graph::label_type> path;
     if (graph.exist(source) && graph.exist(target) && source != target)
     {
-        Predecessor<_Label> pred(std::move(Shortest_path_unchecked<_Label, _Weight, _Visitor>(graph, source)));
-        Construct_shortest_path(target, pred, path);
+        workspace.reset(graph, source);
+        workspace.add_target(target);
+        if (BFS_unchecked_static(graph, workspace, token))
+            Construct_shortest_path(target, workspace, path);
     }
     return path;
 }
@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+// Fixed set of worker threads running parallel_for loops. The calling thread
+// takes part in every loop as thread 0, so a pool of size 1 runs inline.
+class Thread_pool
+{
+public:
+    explicit Thread_pool(size_t threads = std::thread::hardware_concurrency())
+    {
+        if (threads == 0)
+            threads = 1;
+        for (size_t thread = 1; thread < threads; ++thread)
+            m_Workers.emplace_back([this, thread]() { run(thread); });
+    }
+
+    Thread_pool(const Thread_pool&) = delete;
+    Thread_pool& operator=(const Thread_pool&) = delete;
+
+    ~Thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stop = true;
+        }
+        m_Start.notify_all();
+        for (auto& worker : m_Workers)
+            worker.join();
+    }
+
+    size_t size() const { return m_Workers.size() + 1; }
+
+    // calls function(index, thread) for every index in [0, count)
+    template<class Function>
+    void parallel_for(const size_t count, Function function)
+    {
+        std::atomic<size_t> next(0);
+        auto task = [&](const size_t thread) {
+            for (size_t index = next++; index < count; index = next++)
+                function(index, thread);
+        };
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Task = task;
+            m_Active = m_Workers.size();
+            ++m_Generation;
+        }
+        m_Start.notify_all();
+
+        task(0);
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Done.wait(lock, [this]() { return m_Active == 0; });
+        m_Task = nullptr;
+    }
+
+private:
+    void run(const size_t thread)
+    {
+        size_t generation = 0;
+        while (true)
+        {
+            std::function<void(size_t)> task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_Start.wait(lock, [&]() { return m_Stop || m_Generation != generation; });
+                if (m_Stop)
+                    return;
+                generation = m_Generation;
+                task = m_Task;
+            }
+
+            task(thread);
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_Active;
+            }
+            m_Done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_Start;
+    std::condition_variable m_Done;
+    std::function<void(size_t)> m_Task;
+    size_t m_Generation = 0;
+    size_t m_Active = 0;
+    bool m_Stop = false;
+};
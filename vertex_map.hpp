@@ -0,0 +1,185 @@
+#pragma once
+#include "graph.hpp"
+#include <vector>
+#include <map>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+// Position of a label in a flat vector; a negative label would wrap around.
+template<class Key>
+size_t label_index(const Key& key)
+{
+    if (std::is_signed<Key>::value && key < static_cast<Key>(0))
+        throw std::out_of_range("negative label");
+    return static_cast<size_t>(key);
+}
+
+// Map-like container over a flat vector addressed by an integral label.
+template<class Key, class T>
+class Index_map
+{
+public:
+    static_assert(std::is_integral<Key>::value, "Type Key is not integral.");
+
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = typename std::vector<T>::size_type;
+
+    Index_map() = default;
+
+    Index_map(const size_type size, const mapped_type& value)
+        : m_Values(size, value)
+    {
+
+    }
+
+    mapped_type& operator[](const key_type& key)
+    {
+        const auto index = label_index(key);
+        if (index >= m_Values.size())
+            m_Values.resize(index + 1);
+        return m_Values[index];
+    }
+
+    const mapped_type& at(const key_type& key) const
+    {
+        const auto index = static_cast<size_type>(key);
+        if (index >= m_Values.size())
+            throw std::out_of_range("Index_map::at");
+        return m_Values[index];
+    }
+
+    void insert(const value_type& value)
+    {
+        (*this)[value.first] = value.second;
+    }
+
+    void assign(const size_type size, const mapped_type& value) { m_Values.assign(size, value); }
+
+    size_type size() const { return m_Values.size(); }
+    bool empty() const { return m_Values.empty(); }
+    void clear() { m_Values.clear(); }
+
+    const mapped_type* data() const { return m_Values.data(); }
+
+private:
+    std::vector<mapped_type> m_Values;
+};
+
+// Index_map whose clear() is O(1): every entry carries the epoch it was written
+// in, and entries from an older epoch read as the default value.
+template<class Key, class T>
+class Stamped_map
+{
+    using stamp_type = unsigned int;
+
+public:
+    static_assert(std::is_integral<Key>::value, "Type Key is not integral.");
+
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = typename std::vector<T>::size_type;
+
+    Stamped_map() = default;
+
+    mapped_type& operator[](const key_type& key)
+    {
+        const auto index = label_index(key);
+        if (index >= m_Values.size())
+        {
+            m_Values.resize(index + 1, m_Default);
+            m_Stamps.resize(index + 1, 0);
+        }
+        if (m_Stamps[index] != m_Epoch)
+        {
+            m_Stamps[index] = m_Epoch;
+            m_Values[index] = m_Default;
+        }
+        return m_Values[index];
+    }
+
+    const mapped_type& at(const key_type& key) const
+    {
+        const auto index = static_cast<size_type>(key);
+        if (index >= m_Values.size() || m_Stamps[index] != m_Epoch)
+            return m_Default;
+        return m_Values[index];
+    }
+
+    void insert(const value_type& value)
+    {
+        (*this)[value.first] = value.second;
+    }
+
+    void reset(const mapped_type& value)
+    {
+        clear();
+        m_Default = value;
+    }
+
+    size_type size() const { return m_Values.size(); }
+    bool empty() const { return m_Values.empty(); }
+
+    void clear()
+    {
+        if (++m_Epoch == 0)
+        {
+            std::fill(m_Stamps.begin(), m_Stamps.end(), 0);
+            m_Epoch = 1;
+        }
+    }
+
+private:
+    std::vector<mapped_type> m_Values;
+    std::vector<stamp_type> m_Stamps;
+    stamp_type m_Epoch = 1;
+    mapped_type m_Default = mapped_type();
+};
+
+// Dense storage for graphs with dense labels, ordered map for any other graph.
+template<class Label, class T, class GraphType = void>
+using vertex_map = std::conditional_t<has_dense_labels<GraphType>::value, Index_map<Label, T>, std::map<Label, T>>;
+
+struct Default_storage
+{
+    template<class Label, class T, class GraphType = void>
+    using container = vertex_map<Label, T, GraphType>;
+};
+
+struct Stamped_storage
+{
+    template<class Label, class T, class GraphType = void>
+    using container = Stamped_map<Label, T>;
+};
+
+template<class Container, class GraphType, class T>
+void assign_vertices(Container& container, const GraphType& graph, const T& value)
+{
+    graph.for_each_vertex(
+        [&](const auto& label) {
+            container.insert(std::make_pair(label, value));
+        }
+    );
+}
+
+template<class Key, class T, class GraphType>
+void assign_vertices(Index_map<Key, T>& container, const GraphType& graph, const T& value)
+{
+    typename Index_map<Key, T>::size_type bound = 0;
+    graph.for_each_vertex(
+        [&](const auto& label) {
+            bound = std::max(bound, label_index(label) + 1);
+        }
+    );
+    container.assign(bound, value);
+}
+
+template<class Key, class T, class GraphType>
+void assign_vertices(Stamped_map<Key, T>& container, const GraphType&, const T& value)
+{
+    container.reset(value);
+}
@@ -0,0 +1,303 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <type_traits>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <queue>
+#include <cassert>
+
+// Dial's bucket queue for small non-negative integer weights. The buckets form a
+// ring that only has to cover the spread of keys in the queue, i.e. the maximum weight.
+template<class Edge>
+class Bucket_queue
+{
+public:
+    using value_type = Edge;
+    using weight_type = typename Edge::weight_type;
+    using size_type = size_t;
+
+    static_assert(std::is_integral<weight_type>::value, "Type of Weight is not integral.");
+
+    Bucket_queue()
+        : m_Buckets(1)
+    {
+
+    }
+
+    bool empty() const { return m_Size == 0; }
+    size_type size() const { return m_Size; }
+
+    void push(const value_type& value)
+    {
+        const auto key = static_cast<size_type>(value.weight());
+        if (m_Size == 0)
+        {
+            m_Current = key;
+        }
+        else if (key < m_Current)
+        {
+            grow(m_Current + m_Buckets.size() - key);
+            m_Current = key;
+        }
+
+        if (key - m_Current >= m_Buckets.size())
+            grow(key - m_Current + 1);
+
+        m_Buckets[index(key)].push_back(value);
+        ++m_Size;
+    }
+    void emplace(const value_type& value) { push(value); }
+
+    const value_type& top()
+    {
+        while (m_Buckets[index(m_Current)].empty())
+            ++m_Current;
+        return m_Buckets[index(m_Current)].back();
+    }
+
+    void pop()
+    {
+        top();
+        m_Buckets[index(m_Current)].pop_back();
+        --m_Size;
+    }
+
+    // the buckets keep their capacity
+    void clear()
+    {
+        for (auto& bucket : m_Buckets)
+            bucket.clear();
+        m_Current = 0;
+        m_Size = 0;
+    }
+
+private:
+    size_type index(const size_type key) const { return key & (m_Buckets.size() - 1); }
+
+    void grow(const size_type span)
+    {
+        size_type capacity = m_Buckets.size();
+        while (capacity < span)
+            capacity *= 2;
+
+        std::vector<std::vector<value_type>> buckets(capacity);
+        for (auto& bucket : m_Buckets)
+        {
+            for (auto& value : bucket)
+                buckets[static_cast<size_type>(value.weight()) & (capacity - 1)].push_back(value);
+        }
+        m_Buckets.swap(buckets);
+    }
+
+    std::vector<std::vector<value_type>> m_Buckets;
+    size_type m_Current = 0;
+    size_type m_Size = 0;
+};
+
+// Deque for 0-1 BFS: an entry with the key of the last extracted one goes to the
+// front, any larger key to the back. Correct only for edge weights of 0 and 1,
+// i.e. while every key pushed is the last extracted key or one more; other
+// weights break the order silently, so debug builds assert it.
+template<class Edge>
+class Zero_one_queue
+{
+public:
+    using value_type = Edge;
+    using weight_type = typename Edge::weight_type;
+    using size_type = size_t;
+
+    bool empty() const { return m_Queue.empty(); }
+    size_type size() const { return m_Queue.size(); }
+
+    void push(const value_type& value)
+    {
+        assert(!m_Extracted || (!(value.weight() < m_Current) && !(m_Current + 1 < value.weight())));
+        if (!m_Queue.empty() && !(m_Current < value.weight()))
+            m_Queue.push_front(value);
+        else
+            m_Queue.push_back(value);
+    }
+    void emplace(const value_type& value) { push(value); }
+
+    const value_type& top() const { return m_Queue.front(); }
+
+    void pop()
+    {
+        m_Current = m_Queue.front().weight();
+        m_Extracted = true;
+        m_Queue.pop_front();
+    }
+
+    void clear()
+    {
+        m_Queue.clear();
+        m_Current = weight_type();
+        m_Extracted = false;
+    }
+
+private:
+    std::deque<value_type> m_Queue;
+    weight_type m_Current = weight_type();
+    bool m_Extracted = false;
+};
+
+// d-ary min-heap holding at most one entry per vertex. Pushing a vertex that is
+// already queued decreases its key in place instead of adding a duplicate.
+template<class Edge, size_t Arity = 4>
+class Indexed_heap
+{
+public:
+    using value_type = Edge;
+    using label_type = typename Edge::label_type;
+    using weight_type = typename Edge::weight_type;
+    using size_type = size_t;
+
+    static_assert(std::is_integral<label_type>::value, "Type Label is not integral.");
+    static_assert(Arity >= 2, "Heap arity must be at least 2.");
+
+    bool empty() const { return m_Heap.empty(); }
+    size_type size() const { return m_Heap.size(); }
+
+    void push(const value_type& value)
+    {
+        const auto vertex = static_cast<size_type>(value.target());
+        if (vertex >= m_Position.size())
+            m_Position.resize(vertex + 1, npos);
+
+        auto position = m_Position[vertex];
+        if (position == npos)
+        {
+            position = m_Heap.size();
+            m_Heap.push_back(value);
+            m_Position[vertex] = position;
+        }
+        else if (value.weight() < m_Heap[position].weight())
+        {
+            m_Heap[position] = value;
+        }
+        else
+        {
+            return;
+        }
+        sift_up(position);
+    }
+    void emplace(const value_type& value) { push(value); }
+
+    const value_type& top() const { return m_Heap.front(); }
+
+    void pop()
+    {
+        m_Position[static_cast<size_type>(m_Heap.front().target())] = npos;
+        if (m_Heap.size() > 1)
+        {
+            m_Heap.front() = m_Heap.back();
+            m_Heap.pop_back();
+            m_Position[static_cast<size_type>(m_Heap.front().target())] = 0;
+            sift_down(0);
+        }
+        else
+        {
+            m_Heap.pop_back();
+        }
+    }
+
+    // only the positions of queued vertices are touched; both vectors keep their capacity
+    void clear()
+    {
+        for (const auto& value : m_Heap)
+            m_Position[static_cast<size_type>(value.target())] = npos;
+        m_Heap.clear();
+    }
+
+    bool contains(const label_type& vertex) const
+    {
+        const auto index = static_cast<size_type>(vertex);
+        return index < m_Position.size() && m_Position[index] != npos;
+    }
+
+private:
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    void place(const size_type position, const value_type& value)
+    {
+        m_Heap[position] = value;
+        m_Position[static_cast<size_type>(value.target())] = position;
+    }
+
+    void sift_up(size_type position)
+    {
+        const value_type value = m_Heap[position];
+        while (position > 0)
+        {
+            const size_type parent = (position - 1) / Arity;
+            if (!(value.weight() < m_Heap[parent].weight()))
+                break;
+            place(position, m_Heap[parent]);
+            position = parent;
+        }
+        place(position, value);
+    }
+
+    void sift_down(size_type position)
+    {
+        const value_type value = m_Heap[position];
+        const size_type size = m_Heap.size();
+        while (true)
+        {
+            const size_type first = position * Arity + 1;
+            if (first >= size)
+                break;
+
+            const size_type last = std::min(first + Arity, size);
+            size_type best = first;
+            for (size_type child = first + 1; child < last; ++child)
+            {
+                if (m_Heap[child].weight() < m_Heap[best].weight())
+                    best = child;
+            }
+            if (!(m_Heap[best].weight() < value.weight()))
+                break;
+            place(position, m_Heap[best]);
+            position = best;
+        }
+        place(position, value);
+    }
+
+    std::vector<value_type> m_Heap;
+    std::vector<size_type> m_Position;
+};
+
+template<class Edge, size_t Arity>
+constexpr typename Indexed_heap<Edge, Arity>::size_type Indexed_heap<Edge, Arity>::npos;
+
+// Empties a queue without releasing its storage, so a reused search does not
+// allocate its heap again. std::priority_queue only exposes its container to
+// derived classes, as does std::queue.
+template<class T, class Container, class Compare>
+void clear_queue(std::priority_queue<T, Container, Compare>& queue)
+{
+    struct access : std::priority_queue<T, Container, Compare>
+    {
+        static Container& container(std::priority_queue<T, Container, Compare>& queue) { return queue.*&access::c; }
+    };
+    access::container(queue).clear();
+}
+
+template<class T, class Container>
+void clear_queue(std::queue<T, Container>& queue)
+{
+    struct access : std::queue<T, Container>
+    {
+        static Container& container(std::queue<T, Container>& queue) { return queue.*&access::c; }
+    };
+    access::container(queue).clear();
+}
+
+template<class Queue>
+void clear_queue(Queue& queue)
+{
+    queue.clear();
+}
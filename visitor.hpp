@@ -1,5 +1,7 @@
 #pragma once
 #include "graph.hpp"
+#include "vertex_map.hpp"
+#include "vertex_queue.hpp"
 #include <type_traits>
 #include <queue>
 #include <limits>
@@ -9,18 +11,13 @@
 
 enum class color_type { white, gray, black };
 
-template<class Label, class Container = std::map <Label, Label>>
+template<class Label, class Container = vertex_map<Label, Label>>
 class Predecessor
 {
-    template<class GraphIterator>
-    void assign_container(GraphIterator First, GraphIterator Last)
+    template<class GraphType>
+    void assign_container(const GraphType& graph)
     {
-        std::for_each(First, Last,
-            [&](const auto& vertex) {
-                const auto label = vertex.first;
-                m_Predecessor.insert(std::make_pair(label, m_Default));
-            }
-        );
+        assign_vertices(m_Predecessor, graph, m_Default);
     }
 
 public:
@@ -28,10 +25,10 @@ public:
 
     Predecessor(){};
 
-    template<class Weight>
-    Predecessor(const Graph<Label, Weight>& graph)
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    Predecessor(const GraphType& graph)
     {
-        assign_container(graph.cbegin(), graph.cend());
+        assign_container(graph);
     }
 
     explicit Predecessor(const Container& container)
@@ -48,11 +45,11 @@ public:
 
     virtual ~Predecessor() {}
 
-    template<class Weight>
-    Predecessor<Label, Container>& operator=(const Graph<Label, Weight>& graph)
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    Predecessor<Label, Container>& operator=(const GraphType& graph)
     {
         m_Predecessor.clear();
-        assign_container(graph.cbegin(), graph.cend());
+        assign_container(graph);
         return *this;
     }
 
@@ -85,27 +82,28 @@ private:
     Label m_Default = std::is_arithmetic<Label>::value ? std::numeric_limits<Label>::max() : Label();
 };
 
-template<class Label, class Container = std::map<Label, color_type>>
+template<class Label, class Container = vertex_map<Label, color_type>>
 class Color
 {
-    template<class GraphIterator>
-    void assign_container(GraphIterator First, GraphIterator Last)
+    template<class GraphType>
+    void assign_container(const GraphType& graph)
     {
-        std::for_each(First, Last,
-            [&](const auto& vertex) {
-                const auto label = vertex.first;
-                m_Color.insert(std::make_pair(label, color_type::white));
-            }
-        );
+        assign_vertices(m_Color, graph, color_type::white);
     }
 
 public:
     Color() {};
 
-    template<class Weight>
-    Color(const Graph<Label, Weight>& graph, const Label& source)
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    explicit Color(const GraphType& graph)
+    {
+        assign_container(graph);
+    }
+
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    Color(const GraphType& graph, const Label& source)
     {
-        assign_container(graph.cbegin(), graph.cedn());
+        assign_container(graph);
         discovered(source);
     }
 
@@ -123,11 +121,11 @@ public:
 
     virtual ~Color() {}
 
-    template<class Weight>
-    Color<Label, Container>& operator=(const Graph<Label, Weight>& graph)
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    Color<Label, Container>& operator=(const GraphType& graph)
     {
         m_Color.clear();
-        assign_container(graph.cbegin(), graph.cend());
+        assign_container(graph);
         return *this;
     }
 
@@ -154,19 +152,13 @@ private:
     Container m_Color;
 };
 
-template<class Label, class Weight, class Container = std::map<Label, Weight>>
+template<class Label, class Weight, class Container = vertex_map<Label, Weight>>
 class Distance
 {
-    template<class GraphIterator>
-    void assign_container(GraphIterator First, GraphIterator Last)
+    template<class GraphType>
+    void assign_container(const GraphType& graph)
     {
-        std::for_each(First, Last,
-            [&](const auto& vertex) {
-                const auto label = vertex.first;
-                m_Distance.insert(std::make_pair(label, std::numeric_limits<Weight>::max()));
-            }
-        );
-
+        assign_vertices(m_Distance, graph, std::numeric_limits<Weight>::max());
     }
 public:
     static_assert(std::is_arithmetic<Weight>::value, "Type of Weight is not arithmetic.");
@@ -174,9 +166,16 @@ public:
 
     Distance() = delete;
 
-    Distance(const Graph<Label, Weight>& graph, const Label& source)
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    explicit Distance(const GraphType& graph)
     {
-        assign_container(graph.cbegin(), graph.cend());
+        assign_container(graph);
+    }
+
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    Distance(const GraphType& graph, const Label& source)
+    {
+        assign_container(graph);
         m_Distance[source] = static_cast<Weight>(0);
     }
 
@@ -194,10 +193,11 @@ public:
 
     virtual ~Distance() {}
 
-    Distance<Label, Weight, Container>& operator=(const Graph<Label, Weight>& graph)
+    template<class GraphType, std::enable_if_t<is_graph<GraphType>::value, int> = 0>
+    Distance<Label, Weight, Container>& operator=(const GraphType& graph)
     {
         m_Distance.clear();
-        assign_container(graph.cbegin(), graph.cend());
+        assign_container(graph);
         return *this;
     }
 
@@ -215,9 +215,10 @@ public:
         return *this;
     }
 
-    void update(const edge_type& processed_vertex, const edge_type& neighbor_vertex)
+    template<class NeighborEdge>
+    void update(const edge_type& processed_vertex, const NeighborEdge& neighbor_vertex)
     {
-        m_Distance[neighbor_vertex.target()] = processed_vertex.weight() + neighbor_vertex.weight();
+        m_Distance[neighbor_vertex.target()] = static_cast<Weight>(processed_vertex.weight() + neighbor_vertex.weight());
     }
 
     void update(const Label& vertex, const Weight& weight)
@@ -231,21 +232,30 @@ private:
     Container m_Distance;
 };
 
-template<class Label, class Weight>
-class Visitor : public Predecessor<Label>, public Distance<Label, Weight>
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>, class Storage = Default_storage>
+class Visitor
+    : public Predecessor<Label, typename Storage::template container<Label, Label, GraphType>>,
+      public Distance<Label, Weight, typename Storage::template container<Label, Weight, GraphType>>
 {
 public:
     using label_type = Label;
     using weight_type = Weight;
 
     using edge_type = Edge<label_type, weight_type>;
-    using base_predecessor = Predecessor<Label>;
-    using base_distance = Distance<Label, Weight>;
+    using base_predecessor = Predecessor<Label, typename Storage::template container<Label, Label, GraphType>>;
+    using base_distance = Distance<Label, Weight, typename Storage::template container<Label, Weight, GraphType>>;
 
-    using graph_type = Graph<label_type, weight_type>;
+    using graph_type = GraphType;
+    using storage_type = Storage;
 
     Visitor() = delete;
 
+    explicit Visitor(const graph_type& graph)
+        : base_predecessor(graph), base_distance(graph)
+    {
+
+    }
+
     Visitor(const graph_type& graph, const label_type& source)
         : base_predecessor(graph), base_distance(graph, source)
     {
@@ -253,35 +263,93 @@ public:
     }
     virtual ~Visitor() {}
 
-    void update(const edge_type& processed_vertex, const edge_type& neighbor_vertex)
+    void reset(const graph_type& graph, const label_type& source)
+    {
+        base_predecessor::operator=(graph);
+        base_distance::operator=(graph);
+        base_distance::update(source, static_cast<weight_type>(0));
+    }
+
+    // neighbor_vertex is an edge of the graph, whose weight type may be narrower
+    template<class NeighborEdge>
+    void update(const edge_type& processed_vertex, const NeighborEdge& neighbor_vertex)
     {
         base_distance::update(processed_vertex, neighbor_vertex);
         base_predecessor::update(processed_vertex.target(), neighbor_vertex.target());
     }
 };
 
-template<class Label, class Weight, class Queue>
-class Visitor_with_queue : public Visitor<Label, Weight>
+template<class Label, class Weight, class Queue, class GraphType = Graph<Label, Weight>, class Storage = Default_storage>
+class Visitor_with_queue : public Visitor<Label, Weight, GraphType, Storage>
 {
 public:
     using edge_type = Edge<Label, Weight>;
-    using base_visitor = Visitor<Label, Weight>;
+    using base_visitor = Visitor<Label, Weight, GraphType, Storage>;
     using queue_type = Queue;
+    using graph_type = GraphType;
 
-    using edges_const_iterator = typename Graph<Label, Weight>::map_const_iterator;
+    using edges_const_iterator = typename graph_type::map_const_iterator;
 
     Visitor_with_queue() = delete;
 
-    Visitor_with_queue(const Graph<Label, Weight>& graph, const Label& source)
+    explicit Visitor_with_queue(const graph_type& graph)
+        : base_visitor(graph)
+    {
+
+    }
+
+    Visitor_with_queue(const graph_type& graph, const Label& source)
         : base_visitor(graph,source)
     {
         push(source);
     }
     virtual ~Visitor_with_queue() {}
 
+    void reset(const graph_type& graph, const Label& source)
+    {
+        base_visitor::reset(graph, source);
+        clear_queue(m_Queue);
+        m_Targets.clear();
+        m_Pending = 0;
+        m_Sorted = true;
+        push(source);
+    }
+
+    void add_target(const Label& vertex)
+    {
+        m_Targets.emplace_back(vertex, false);
+        ++m_Pending;
+        m_Sorted = false;
+    }
+
+    template<class InputIterator>
+    void add_targets(InputIterator First, InputIterator Last)
+    {
+        for (; First != Last; ++First)
+            add_target(*First);
+    }
+
+    // true once the last pending target is settled
+    bool settle(const Label& vertex)
+    {
+        if (m_Pending == 0)
+            return false;
+        if (!m_Sorted)
+            sort_targets();
+
+        const auto target = std::lower_bound(m_Targets.begin(), m_Targets.end(), vertex,
+            [](const auto& entry, const Label& label) { return entry.first < label; });
+        if (target == m_Targets.end() || vertex < target->first || target->second)
+            return false;
+
+        target->second = true;
+        return --m_Pending == 0;
+    }
+
     virtual void handle(edges_const_iterator& First, edges_const_iterator& Last, const edge_type& processed_vertex) = 0;
 
     virtual edge_type extract_vertex() = 0;
+    virtual edge_type top_vertex() = 0;
 
     void push(const Label& vertex)
     {
@@ -291,22 +359,51 @@ public:
 
 protected:
     queue_type m_Queue;
+
+private:
+    // sorted by label with duplicates merged; a merged entry is settled if any copy was
+    void sort_targets()
+    {
+        std::sort(m_Targets.begin(), m_Targets.end(),
+            [](const auto& left, const auto& right) { return left.first < right.first || (!(right.first < left.first) && left.second > right.second); });
+        m_Targets.erase(std::unique(m_Targets.begin(), m_Targets.end(),
+            [](const auto& left, const auto& right) { return !(left.first < right.first) && !(right.first < left.first); }), m_Targets.end());
+        m_Pending = std::count_if(m_Targets.begin(), m_Targets.end(), [](const auto& entry) { return !entry.second; });
+        m_Sorted = true;
+    }
+
+    // flat, so reset() keeps the capacity instead of freeing one node per target
+    std::vector<std::pair<Label, bool>> m_Targets;
+    size_t m_Pending = 0;
+    bool m_Sorted = true;
 };
 
-template<class Label, class Weight>
+template<
+    class Label, class Weight,
+    class GraphType = Graph<Label, Weight>,
+    class Storage = Default_storage,
+    class Queue = std::priority_queue<Edge<Label, Weight>, std::vector<Edge<Label, Weight>>, std::greater<Edge<Label, Weight>>>
+>
 class Dijkstra_visitor
-    : public Visitor_with_queue<Label, Weight, std::priority_queue<Edge<Label, Weight>, std::vector<Edge<Label, Weight>>, std::greater<Edge<Label, Weight>>>>
+    : public Visitor_with_queue<Label, Weight, Queue, GraphType, Storage>
 {
 public:
     using edge_type = Edge<Label, Weight>;
-    using queue_type = std::priority_queue<edge_type, std::vector<edge_type>, std::greater<edge_type>>;
-    using base_visitor = Visitor_with_queue<Label, Weight, queue_type>;
+    using queue_type = Queue;
+    using base_visitor = Visitor_with_queue<Label, Weight, queue_type, GraphType, Storage>;
+    using graph_type = GraphType;
 
     using edges_const_iterator = typename base_visitor::edges_const_iterator;
 
     Dijkstra_visitor() = delete;
 
-    Dijkstra_visitor(const Graph<Label, Weight>& graph, const Label& source)
+    explicit Dijkstra_visitor(const graph_type& graph)
+        : base_visitor(graph)
+    {
+
+    }
+
+    Dijkstra_visitor(const graph_type& graph, const Label& source)
         : base_visitor(graph, source)
     {
 
@@ -316,6 +413,10 @@ public:
 
     virtual void handle(edges_const_iterator& First, edges_const_iterator& Last, const edge_type& processed_vertex) override
     {
+        // stale queue entry of an already settled vertex
+        if (this->distance(processed_vertex.target()) < processed_vertex.weight())
+            return;
+
         std::for_each(First, Last,
             [&](const auto& neighbor) {
                 auto total_distance = processed_vertex.weight() + neighbor.weight();
@@ -335,29 +436,49 @@ public:
         return vertex;
     }
 
+    virtual edge_type top_vertex() override
+    {
+        return base_visitor::m_Queue.top();
+    }
+
 };
 
-template<class Label, class Weight>
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>, class Storage = Default_storage>
 class BFS_visitor final
-    : public Visitor_with_queue<Label, Weight, std::queue<Edge<Label, Weight>>>, public Color<Label>
+    : public Visitor_with_queue<Label, Weight, std::queue<Edge<Label, Weight>>, GraphType, Storage>,
+      public Color<Label, typename Storage::template container<Label, color_type, GraphType>>
 {
 public:
     using edge_type = Edge<Label, Weight>;
     using queue_type = std::queue<edge_type>;
-    using base_visitor = Visitor_with_queue<Label, Weight, queue_type>;
-    using base_color = Color<Label>;
+    using base_visitor = Visitor_with_queue<Label, Weight, queue_type, GraphType, Storage>;
+    using base_color = Color<Label, typename Storage::template container<Label, color_type, GraphType>>;
+    using graph_type = GraphType;
 
     using edges_const_iterator = typename base_visitor::edges_const_iterator;
 
     BFS_visitor() = delete;
 
-    BFS_visitor(const Graph<Label, Weight>& graph, const Label& source)
+    explicit BFS_visitor(const graph_type& graph)
+        : base_visitor(graph), base_color(graph)
+    {
+
+    }
+
+    BFS_visitor(const graph_type& graph, const Label& source)
         : base_visitor(graph, source), base_color(graph, source)
     {
 
     }
     ~BFS_visitor() {}
 
+    void reset(const graph_type& graph, const Label& source)
+    {
+        base_visitor::reset(graph, source);
+        base_color::operator=(graph);
+        base_color::discovered(source);
+    }
+
     void handle(edges_const_iterator& First, edges_const_iterator& Last, const edge_type& processed_vertex) override
     {
         std::for_each(First, Last,
@@ -378,8 +499,108 @@ public:
         base_visitor::m_Queue.pop();
         return vertex;
     }
+
+    edge_type top_vertex() override
+    {
+        return base_visitor::m_Queue.front();
+    }
 };
 
+// Orders the queue by distance + heuristic(vertex); the heuristic must be
+// consistent for the first extraction of a vertex to be final.
+template<
+    class Label, class Weight, class Heuristic,
+    class GraphType = Graph<Label, Weight>,
+    class Storage = Default_storage,
+    class Queue = std::priority_queue<Edge<Label, Weight>, std::vector<Edge<Label, Weight>>, std::greater<Edge<Label, Weight>>>
+>
+class AStar_visitor
+    : public Visitor_with_queue<Label, Weight, Queue, GraphType, Storage>
+{
+public:
+    using edge_type = Edge<Label, Weight>;
+    using queue_type = Queue;
+    using heuristic_type = Heuristic;
+    using base_visitor = Visitor_with_queue<Label, Weight, queue_type, GraphType, Storage>;
+    using graph_type = GraphType;
+
+    using edges_const_iterator = typename base_visitor::edges_const_iterator;
+
+    AStar_visitor() = delete;
+
+    AStar_visitor(const graph_type& graph, const Label& source, const heuristic_type& heuristic)
+        : base_visitor(graph, source), m_Heuristic(heuristic)
+    {
+
+    }
+
+    virtual ~AStar_visitor() {}
+
+    void reset(const graph_type& graph, const Label& source, const heuristic_type& heuristic)
+    {
+        m_Heuristic = heuristic;
+        base_visitor::reset(graph, source);
+    }
+
+    virtual void handle(edges_const_iterator& First, edges_const_iterator& Last, const edge_type& processed_vertex) override
+    {
+        const auto vertex = processed_vertex.target();
+        const auto distance = this->distance(vertex);
+
+        // stale queue entry of an already settled vertex
+        if (distance + m_Heuristic(vertex) < processed_vertex.weight())
+            return;
+
+        const edge_type settled_vertex(vertex, distance);
+        std::for_each(First, Last,
+            [&](const auto& neighbor) {
+                auto total_distance = distance + neighbor.weight();
+
+                if (total_distance < this->distance(neighbor.target()))
+                {
+                    base_visitor::update(settled_vertex, neighbor);
+                    push(neighbor.target());
+                }
+            });
+    }
+
+    virtual edge_type extract_vertex() override
+    {
+        edge_type vertex = base_visitor::m_Queue.top();
+        base_visitor::m_Queue.pop();
+        return vertex;
+    }
+
+    virtual edge_type top_vertex() override
+    {
+        return base_visitor::m_Queue.top();
+    }
+
+    void push(const Label& vertex)
+    {
+        base_visitor::m_Queue.emplace(edge_type(vertex, this->distance(vertex) + m_Heuristic(vertex)));
+    }
+
+private:
+    heuristic_type m_Heuristic;
+};
+
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>, class Storage = Default_storage>
+using Dial_visitor = Dijkstra_visitor<Label, Weight, GraphType, Storage, Bucket_queue<Edge<Label, Weight>>>;
+
+// every edge weight must be 0 or 1
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>, class Storage = Default_storage>
+using Zero_one_visitor = Dijkstra_visitor<Label, Weight, GraphType, Storage, Zero_one_queue<Edge<Label, Weight>>>;
+
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>, class Storage = Default_storage>
+using Indexed_heap_visitor = Dijkstra_visitor<Label, Weight, GraphType, Storage, Indexed_heap<Edge<Label, Weight>>>;
+
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>>
+using Dijkstra_workspace = Dijkstra_visitor<Label, Weight, GraphType, Stamped_storage>;
+
+template<class Label, class Weight, class GraphType = Graph<Label, Weight>>
+using BFS_workspace = BFS_visitor<Label, Weight, GraphType, Stamped_storage>;
+
 // TODO
 template<class Label, class Weight>
 class Prim_visitor : public Dijkstra_visitor<Label, Weight>